@@ -0,0 +1,306 @@
+// Times each stage of the generator on synthetic configs and templates, results are printed as JSON lines:
+// {"scenario": ..., "stage": ..., "iterations": ..., "min_ms": ..., "mean_ms": ..., "max_ms": ...}
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "Template.h"
+#include "VgaDebugGenerator.h"
+
+struct Scenario {
+    std::string name;
+    int num_wires;
+    int num_blocks;
+    int depth; // length of the submodule chain
+    int group_size; // wires in a group referenced by 'len_bits', 'wire_prefix', 'wire_suffix' and 'submodule'
+    int width;
+    int height; // at least this, grows to fit all wires
+};
+
+struct Inputs {
+    std::string config;
+    std::string templte;
+    int height;
+};
+
+// Every wire 'wJ' in block 'bI' is displayed as 8 hex digits, except every 7th one, which has 2 hex digits
+// and 5 bits. The first 'group_size' wires are in a group owned by submodule 'Group', the others are assigned
+// to the submodules of the chain in turn.
+Inputs Synthesize(const Scenario &scenario, const std::string &dir) {
+    std::ostringstream temp;
+    temp << "Synthetic benchmark template '" << scenario.name << "'\n";
+    int height = 1;
+    std::vector<std::vector<std::string>> block_wires(scenario.num_blocks);
+    for (int b = 0; b < scenario.num_blocks; b++) {
+        temp << "== b" << b << " ==\n";
+        ++height;
+        int begin = static_cast<long long>(scenario.num_wires) * b / scenario.num_blocks;
+        int end = static_cast<long long>(scenario.num_wires) * (b + 1) / scenario.num_blocks;
+        int col = 0;
+        for (int w = begin; w < end; w++) {
+            auto name = "w" + std::to_string(w);
+            auto item = name + ": " + std::string(w % 7 == 0 ? 2 : 8, '0');
+            if (col > 0 && col + 1 + item.size() > scenario.width) {
+                temp << '\n';
+                ++height;
+                col = 0;
+            }
+            temp << (col > 0 ? " " : "") << item;
+            col += (col > 0 ? 1 : 0) + item.size();
+            block_wires[b].emplace_back(name);
+        }
+        if (col > 0) {
+            temp << '\n';
+            ++height;
+        }
+    }
+    height = std::max(height, scenario.height);
+
+    auto wire_list = [](const std::vector<std::string> &names) {
+        std::string str = "[";
+        for (int i = 0; i < names.size(); i++) {
+            str += (i > 0 ? ", \"" : "\"") + names[i] + "\"";
+        }
+        return str + "]";
+    };
+
+    // the first 'group_size' wires form the group, others are listed explicitly
+    std::vector<std::vector<std::string>> group_wires(scenario.num_blocks);
+    std::vector<std::vector<std::vector<std::string>>> sub_wires(scenario.depth,
+        std::vector<std::vector<std::string>>(scenario.num_blocks));
+    std::vector<std::vector<std::string>> short_wires(scenario.num_blocks);
+    int index = 0;
+    for (int b = 0; b < scenario.num_blocks; b++) {
+        for (const auto &name : block_wires[b]) {
+            int w = std::stoi(name.substr(1));
+            if (w % 7 == 0) {
+                short_wires[b].emplace_back(name);
+            }
+            if (index < scenario.group_size) {
+                group_wires[b].emplace_back(name);
+            } else if (scenario.depth > 0) {
+                sub_wires[index % scenario.depth][b].emplace_back(name);
+            }
+            ++index;
+        }
+    }
+
+    std::ostringstream config;
+    config << "{\n";
+    config << "    \"module_name\": \"Top\",\n";
+    config << "    \"template_file\": \"" << (std::filesystem::path(dir) / "template.txt").generic_string() << "\",\n";
+    config << "    \"output_dir\": \"" << std::filesystem::path(dir).generic_string() << "\",\n";
+    config << "    \"mem_file\": \"bench.mem\",\n";
+    config << "    \"dbg_header\": \"bench.vh\",\n";
+    config << "    \"header_lines\": 1,\n";
+    config << "    \"template_width\": " << scenario.width << ",\n";
+    config << "    \"template_height\": " << height << ",\n";
+    config << "    \"block_prefix\": {";
+    for (int b = 0; b < scenario.num_blocks; b++) {
+        config << (b > 0 ? ", " : " ") << "\"b" << b << "\": \"b" << b << "_\"";
+    }
+    config << " },\n";
+    config << "    \"wire_group\": [ { \"name\": \"big\", \"wires\": {";
+    for (int b = 0, first = 1; b < scenario.num_blocks; b++) {
+        if (!group_wires[b].empty()) {
+            config << (first ? " " : ", ") << "\"b" << b << "\": " << wire_list(group_wires[b]);
+            first = 0;
+        }
+    }
+    config << " } } ],\n";
+    config << "    \"len_bits\": { \"*big\": 32";
+    for (int b = 0; b < scenario.num_blocks; b++) {
+        config << ", \"b" << b << "\": {";
+        for (int i = 0; i < short_wires[b].size(); i++) {
+            config << (i > 0 ? ", \"" : " \"") << short_wires[b][i] << "\": 5";
+        }
+        config << " }";
+    }
+    config << " },\n";
+    config << "    \"wire_prefix\": { \"*big\": \"g_\" },\n";
+    config << "    \"wire_suffix\": { \"*big\": \"_q\" },\n";
+    config << "    \"submodule\": [ { \"name\": \"Group\", \"wires\": { \"*big\": [] } }";
+    for (int d = 0; d < scenario.depth; d++) {
+        config << ",\n        { \"name\": \"Sub" << d << "\"";
+        if (d > 0) {
+            config << ", \"parent\": \"Sub" << d - 1 << "\"";
+        }
+        config << ", \"wires\": {";
+        for (int b = 0, first = 1; b < scenario.num_blocks; b++) {
+            if (!sub_wires[d][b].empty()) {
+                config << (first ? " " : ", ") << "\"b" << b << "\": " << wire_list(sub_wires[d][b]);
+                first = 0;
+            }
+        }
+        config << " } }";
+    }
+    config << " ]\n";
+    config << "}\n";
+
+    return Inputs { config.str(), temp.str(), height };
+}
+
+class GeneratorBench {
+public:
+    GeneratorBench(const Scenario &scenario, int iterations) : scenario(scenario), iterations(iterations) {}
+
+    bool Run(const std::string &dir) {
+        std::filesystem::create_directories(dir);
+        auto inputs = Synthesize(scenario, dir);
+        {
+            std::ofstream fout(std::filesystem::path(dir) / "template.txt", std::ios::binary);
+            fout << inputs.templte;
+        }
+
+        std::ostringstream null_out;
+        VgaDebugGenerator generator(null_out, std::cerr);
+
+        bool ok = true;
+        Time("Config::From", [&]() {
+            std::istringstream fin(inputs.config);
+            auto config_opt = Config::From(fin);
+            ok &= config_opt.has_value();
+            if (config_opt.has_value()) {
+                generator.config = std::make_shared<const Config>(std::move(config_opt.value()));
+            }
+        });
+        // the previous path, which builds a DOM first, for comparison
+        Time("Config::FromDom", [&]() {
+            std::istringstream fin(inputs.config);
+            ok &= Config::FromDom(fin).has_value();
+        });
+        if (!ok) {
+            return false;
+        }
+        Time("Template::From", [&]() {
+            auto temp_opt = Template::From(MappedFile::FromString(inputs.templte), generator.config->header_lines,
+                generator.config->template_width, generator.config->template_height);
+            ok &= temp_opt.has_value();
+            if (temp_opt.has_value()) {
+                generator.templte = std::make_shared<const Template>(std::move(temp_opt.value()));
+            }
+        });
+        if (!ok) {
+            return false;
+        }
+
+        try {
+            // 'ProcessModules' consumes the result of 'ProcessConfig', so they are timed in pairs
+            std::vector<double> config_ms, modules_ms;
+            for (int i = 0; i < iterations; i++) {
+                config_ms.emplace_back(TimeOnce([&]() { generator.ProcessConfig(); }));
+                modules_ms.emplace_back(TimeOnce([&]() {
+                    generator.ProcessModules(generator.config->module_name);
+                }));
+            }
+            Report("ProcessConfig", config_ms);
+            Report("ProcessModules", modules_ms);
+
+            Time("Generate_Mem", [&]() { generator.Generate_Mem(); });
+            Time("Generate_VgaDebugger", [&]() { generator.Generate_VgaDebugger(); });
+            Time("Generate_VgaDisplay", [&]() { generator.Generate_VgaDisplay(); });
+            Time("Generate_Header", [&]() {
+                Emitter out;
+                generator.Generate_VgaInstance(out);
+                generator.Generate_Modules(out);
+                generator.WriteOutput(out, generator.config->dbg_header, "debug header file");
+            });
+            // frames of the software model, each after a value of every wire is changed
+            auto renderer = generator.MakeRenderer(std::vector<unsigned char>(256 * 16, 0x5a));
+            uint64_t value = 0;
+            Time("FrameRenderer_x100", [&]() {
+                for (int frame = 0; frame < 100; frame++) {
+                    for (const auto &wire : generator.wires) {
+                        renderer.SetValue(wire.full_name, value++);
+                    }
+                    renderer.Pixels();
+                }
+            });
+        } catch (const std::string &error_msg) {
+            std::cerr << scenario.name << ": " << error_msg << std::endl;
+            return false;
+        } catch (const std::exception &e) {
+            std::cerr << scenario.name << ": " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static double TimeOnce(const std::function<void()> &func) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Time(const std::string &stage, const std::function<void()> &func) {
+        std::vector<double> ms;
+        for (int i = 0; i < iterations; i++) {
+            ms.emplace_back(TimeOnce(func));
+        }
+        Report(stage, ms);
+    }
+
+    void Report(const std::string &stage, const std::vector<double> &ms) {
+        double sum = 0;
+        for (auto t : ms) {
+            sum += t;
+        }
+        std::cout << "{\"scenario\": \"" << scenario.name << "\", \"stage\": \"" << stage << "\", \"iterations\": "
+            << ms.size() << ", \"min_ms\": " << *std::min_element(ms.begin(), ms.end()) << ", \"mean_ms\": "
+            << sum / ms.size() << ", \"max_ms\": " << *std::max_element(ms.begin(), ms.end()) << "}" << std::endl;
+    }
+
+    Scenario scenario;
+    int iterations;
+};
+
+int main(int argc, char *argv[]) {
+    std::vector<Scenario> scenarios = {
+        // name, wires, blocks, depth, group size, width, height
+        { "small", 200, 8, 2, 32, 80, 30 },
+        { "many_wires", 10000, 100, 4, 256, 256, 30 },
+        { "deep_chain", 2000, 20, 64, 32, 160, 30 },
+        { "big_group", 8000, 40, 4, 6000, 256, 30 },
+        { "big_screen", 3000, 30, 8, 256, 240, 135 },
+    };
+
+    int iterations = 5;
+    std::string only;
+    auto dir = (std::filesystem::temp_directory_path() / "vga_dbg_bench").string();
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            iterations = std::max(std::atoi(argv[++i]), 1);
+        } else if (arg == "-s" && i + 1 < argc) {
+            only = argv[++i];
+        } else if (arg == "-o" && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            std::cerr << "Usage: ./vga_debug_generator_bench [-n <iterations>] [-s <scenario>] [-o <output-dir>]"
+                << std::endl;
+            return -1;
+        }
+    }
+
+    int failed = 0;
+    for (const auto &scenario : scenarios) {
+        if (!only.empty() && scenario.name != only) {
+            continue;
+        }
+        GeneratorBench bench(scenario, iterations);
+        if (!bench.Run((std::filesystem::path(dir) / scenario.name).string())) {
+            ++failed;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+# Writes a header defining VGA_DBG_GEN_SOURCE_HASH, a hash of the sources of the generator, so that outputs cached
+# by a build from other sources are regenerated. Run as a script:
+#   cmake -DSOURCES=<file>|<file>... -DOUTPUT=<header> -P SourceHash.cmake
+
+string(REPLACE "|" ";" source_list "${SOURCES}")
+list(SORT source_list)
+
+set(hashes "")
+foreach(source IN LISTS source_list)
+    get_filename_component(source_name "${source}" NAME)
+    file(SHA256 "${source}" source_hash)
+    string(APPEND hashes "${source_name} ${source_hash}\n")
+endforeach()
+string(SHA256 hash "${hashes}")
+string(SUBSTRING "${hash}" 0 16 hash)
+
+set(content "#pragma once\n\n// generated from the sources of the generator by cmake/SourceHash.cmake\n")
+string(APPEND content "#define VGA_DBG_GEN_SOURCE_HASH \"${hash}\"\n")
+
+# only written if changed, so that nothing is rebuilt for an unchanged hash
+if (EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" old_content)
+endif()
+if (NOT old_content STREQUAL content)
+    file(WRITE "${OUTPUT}" "${content}")
+endif()
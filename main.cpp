@@ -1,15 +1,120 @@
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "Batch.h"
 #include "VgaDebugGenerator.h"
 
+namespace {
+
+void PrintUsage() {
+    std::cerr << "Usage: ./vga_debug_generator [-f|--force] [-w|--watch] [-j <threads>] "
+        "[--stats[=text|json]] [--report[=text|json]] "
+        "[--render[=txt|ppm|png] <trace-file> [--font <font-file>]] [-m|--manifest <manifest-file>] <config-file-path>..." << std::endl;
+    std::cerr << "  -f, --force     regenerate even if the inputs are not changed" << std::endl;
+    std::cerr << "  -w, --watch     keep running and regenerate when the config or template file is modified" << std::endl;
+    std::cerr << "  --stats, --profile" << std::endl;
+    std::cerr << "                  print time and peak memory of each phase, sizes of outputs and other counts,"
+        << std::endl;
+    std::cerr << "                  as text (default) or as JSON in one line" << std::endl;
+    std::cerr << "  --report        print an estimate of the generated hardware: BRAM bits, LUTs, logic levels,"
+        << std::endl;
+    std::cerr << "                  port bits and refresh latency, as text (default) or as JSON in one line,"
+        << std::endl;
+    std::cerr << "                  outputs are regenerated for it even if they are up to date" << std::endl;
+    std::cerr << "  --render        render a frame of the display for each line of values in the trace file, into"
+        << std::endl;
+    std::cerr << "                  'frames/' in the output directory, as a character grid, PPM (default) or PNG"
+        << std::endl;
+    std::cerr << "  --font          font of the display (default: vga/font_8x16.mem)" << std::endl;
+    std::cerr << "  -j <threads>    number of threads used for several configs (default: number of cores)" << std::endl;
+    std::cerr << "  -m, --manifest  read config file paths from a file, one per line" << std::endl;
+}
+
+}
+
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: ./vga_debug_generator <config-file-path>" << std::endl;
+    std::vector<std::string> config_files;
+    bool force = false;
+    bool watch = false;
+    auto stats_format = StatsFormat::None;
+    auto report_format = StatsFormat::None;
+    std::string trace_file;
+    auto frame_format = FrameFormat::Ppm;
+    std::string font_file = "vga/font_8x16.mem";
+    int num_threads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-f" || arg == "--force") {
+            force = true;
+        } else if (arg == "-w" || arg == "--watch") {
+            watch = true;
+        } else if (arg == "--stats" || arg == "--profile" || arg == "--stats=text" || arg == "--profile=text") {
+            stats_format = StatsFormat::Text;
+        } else if (arg == "--stats=json" || arg == "--profile=json") {
+            stats_format = StatsFormat::Json;
+        } else if (arg == "--report" || arg == "--report=text") {
+            report_format = StatsFormat::Text;
+        } else if (arg == "--report=json") {
+            report_format = StatsFormat::Json;
+        } else if ((arg == "--render" || arg == "--render=ppm") && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else if (arg == "--render=txt" && i + 1 < argc) {
+            trace_file = argv[++i];
+            frame_format = FrameFormat::Txt;
+        } else if (arg == "--render=png" && i + 1 < argc) {
+            trace_file = argv[++i];
+            frame_format = FrameFormat::Png;
+        } else if (arg == "--font" && i + 1 < argc) {
+            font_file = argv[++i];
+        } else if (arg == "-j" && i + 1 < argc) {
+            num_threads = std::atoi(argv[++i]);
+        } else if ((arg == "-m" || arg == "--manifest") && i + 1 < argc) {
+            if (!ReadManifest(argv[++i], config_files)) {
+                std::cerr << "Failed to open manifest file '" << argv[i] << "'" << std::endl;
+                return -1;
+            }
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            PrintUsage();
+            return -1;
+        } else {
+            config_files.emplace_back(arg);
+        }
+    }
+    if (config_files.empty()) {
+        PrintUsage();
         return -1;
     }
 
-    VgaDebugGenerator generator;
-    generator.Run(argv[1]);
-    
-    return 0;
+    if (!trace_file.empty()) {
+        if (config_files.size() != 1 || watch) {
+            std::cerr << "Rendering only supports one config file" << std::endl;
+            return -1;
+        }
+        // regenerated even if up to date, since the model is built from the resolved wires
+        VgaDebugGenerator generator;
+        generator.SetStatsFormat(stats_format);
+        generator.SetReportFormat(report_format);
+        bool ok = generator.Run(config_files[0], true)
+            && generator.RenderTrace(trace_file, font_file, frame_format);
+        return ok ? 0 : 1;
+    }
+    if (watch) {
+        if (config_files.size() != 1) {
+            std::cerr << "Watch mode only supports one config file" << std::endl;
+            return -1;
+        }
+        VgaDebugGenerator generator;
+        generator.SetStatsFormat(stats_format);
+        generator.SetReportFormat(report_format);
+        return generator.Watch(config_files[0]) ? 0 : 1;
+    }
+    if (config_files.size() == 1) {
+        VgaDebugGenerator generator;
+        generator.SetStatsFormat(stats_format);
+        generator.SetReportFormat(report_format);
+        return generator.Run(config_files[0], force) ? 0 : 1;
+    }
+    return RunBatch(config_files, num_threads, force, stats_format, report_format) == 0 ? 0 : 1;
 }
@@ -0,0 +1,66 @@
+#include "Batch.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+#include "Template.h"
+#include "ThreadPool.h"
+#include "VgaDebugGenerator.h"
+
+bool ReadManifest(const std::string &manifest_file, std::vector<std::string> &config_files) {
+    std::ifstream fin(manifest_file);
+    if (!fin) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(fin, line)) {
+        auto l_index = line.find_first_not_of(" \t\r");
+        if (l_index == std::string::npos || line[l_index] == '#') {
+            continue;
+        }
+        auto r_index = line.find_last_not_of(" \t\r");
+        config_files.emplace_back(line.substr(l_index, r_index - l_index + 1));
+    }
+    return true;
+}
+
+int RunBatch(const std::vector<std::string> &config_files, int num_threads, bool force, StatsFormat stats_format,
+    StatsFormat report_format) {
+    auto start = std::chrono::steady_clock::now();
+
+    TemplateCache template_cache;
+    std::mutex print_mutex;
+    int failed = 0;
+    {
+        ThreadPool pool(num_threads);
+        for (const auto &config_file : config_files) {
+            pool.Submit([&, config_file]() {
+                auto job_start = std::chrono::steady_clock::now();
+                std::ostringstream sout;
+                VgaDebugGenerator generator(sout, sout, &template_cache);
+                generator.SetStatsFormat(stats_format);
+                generator.SetReportFormat(report_format);
+                bool ok = generator.Run(config_file, force);
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - job_start)
+                    .count();
+
+                std::lock_guard lock(print_mutex);
+                std::cout << "==> " << config_file << (ok ? " (done, " : " (FAILED, ") << std::fixed
+                    << std::setprecision(3) << ms << " ms)\n" << sout.str() << std::flush;
+                if (!ok) {
+                    ++failed;
+                }
+            });
+        }
+        pool.Wait();
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << config_files.size() << " config(s), " << failed << " failed, " << std::fixed
+        << std::setprecision(3) << ms << " ms" << std::endl;
+    return failed;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Stats.h"
+
+// Reads config file paths from 'manifest_file', one per line. Empty lines and lines starting with '#' are ignored.
+bool ReadManifest(const std::string &manifest_file, std::vector<std::string> &config_files);
+
+// Runs a generator for each config file on a thread pool, templates shared by several configs are parsed once.
+// Messages of each config are printed together after it is finished. Returns the number of failed configs.
+int RunBatch(const std::vector<std::string> &config_files, int num_threads, bool force,
+    StatsFormat stats_format = StatsFormat::None, StatsFormat report_format = StatsFormat::None);
@@ -1,8 +1,11 @@
 #include "Config.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "nlohmann/json.hpp"
@@ -11,6 +14,15 @@ using json = nlohmann::json;
 
 namespace {
 
+// an integer which fits in an 'int', larger ones are taken as a wrong type
+bool IsInt(const json &json) {
+    if (json.is_number_unsigned()) {
+        return json.get<json::number_unsigned_t>() <= std::numeric_limits<int>::max();
+    }
+    return json.is_number_integer() && json.get<json::number_integer_t>() >= std::numeric_limits<int>::min()
+        && json.get<json::number_integer_t>() <= std::numeric_limits<int>::max();
+}
+
 bool CheckBlockPrefix(const json &json) {
     if (!json.is_object()) {
         return false;
@@ -23,6 +35,11 @@ bool CheckBlockPrefix(const json &json) {
     return true;
 }
 
+Group *FindGroup(const std::string &name, Config &config) {
+    auto it = config.group_ids.find(name);
+    return it == config.group_ids.end() ? nullptr : &config.groups[it->second];
+}
+
 bool ParseGroup(const json &json, Config &config) {
     if (json.type() != json::value_t::array) {
         return false;
@@ -39,6 +56,9 @@ bool ParseGroup(const json &json, Config &config) {
         }
         Group group {};
         group.name = obj["name"].get<std::string>();
+        if (config.group_ids.count(group.name)) {
+            return false;
+        }
 
         if (!obj.contains("wires") || !obj["wires"].is_object()) {
             return false;
@@ -53,16 +73,16 @@ bool ParseGroup(const json &json, Config &config) {
                 if (!wire.is_string()) {
                     return false;
                 }
-                group.wires.emplace_back(key, wire.get<std::string>());
+                group.wires.emplace_back(Config::WireKey(config.strings.Intern(key),
+                    config.strings.Intern(wire.get<std::string>())));
             }
         }
 
-        if (config.groups.count(group.name)) {
-            return false;
-        }
-        config.groups[group.name] = group;
+        config.group_ids[group.name] = config.groups.size();
+        config.groups.emplace_back(std::move(group));
     }
 
+    config.IndexGroups();
     return true;
 }
 
@@ -77,14 +97,11 @@ bool ParseWirePrefix(const json &json, Config &config) {
                 return false;
             }
 
-            auto group_name = key.substr(1);
-            if (config.groups.count(group_name)) {
-                for (const auto &wire : config.groups[group_name].wires) {
-                    config.wire_prefix[wire.first][wire.second] = value.get<std::string>();
-                }
-            } else {
+            auto *group = FindGroup(key.substr(1), config);
+            if (!group) {
                 return false;
             }
+            group->attrs.prefix = config.strings.Intern(value.get<std::string>());
         } else {
             if (!value.is_object()) {
                 return false;
@@ -94,7 +111,7 @@ bool ParseWirePrefix(const json &json, Config &config) {
                 if (!value2.is_string()) {
                     return false;
                 }
-                config.wire_prefix[key][key2] = value2.get<std::string>();
+                config.Attrs(key, key2).prefix = config.strings.Intern(value2.get<std::string>());
             }
         }
     }
@@ -113,14 +130,11 @@ bool ParseWireSuffix(const json &json, Config &config) {
                 return false;
             }
 
-            auto group_name = key.substr(1);
-            if (config.groups.count(group_name)) {
-                for (const auto &wire : config.groups[group_name].wires) {
-                    config.wire_suffix[wire.first][wire.second] = value.get<std::string>();
-                }
-            } else {
+            auto *group = FindGroup(key.substr(1), config);
+            if (!group) {
                 return false;
             }
+            group->attrs.suffix = config.strings.Intern(value.get<std::string>());
         } else {
             if (!value.is_object()) {
                 return false;
@@ -130,7 +144,7 @@ bool ParseWireSuffix(const json &json, Config &config) {
                 if (!value2.is_string()) {
                     return false;
                 }
-                config.wire_suffix[key][key2] = value2.get<std::string>();
+                config.Attrs(key, key2).suffix = config.strings.Intern(value2.get<std::string>());
             }
         }
     }
@@ -152,7 +166,7 @@ bool ParseWireName(const json &json, Config &config) {
             if (!value2.is_string()) {
                 return false;
             }
-            config.wire_name[key][key2] = value2.get<std::string>();
+            config.Attrs(key, key2).name = config.strings.Intern(value2.get<std::string>());
         }
     }
 
@@ -166,28 +180,25 @@ bool ParseLenBits(const json &json, Config &config) {
 
     for (const auto &[key, value] : json.items()) {
         if (key.length() > 0 && key[0] == '*') {
-            if (!value.is_number_integer()) {
+            if (!IsInt(value)) {
                 return false;
             }
 
-            auto group_name = key.substr(1);
-            if (config.groups.count(group_name)) {
-                for (const auto &wire : config.groups[group_name].wires) {
-                    config.len_bits[wire.first][wire.second] = value.get<int>();
-                }
-            } else {
+            auto *group = FindGroup(key.substr(1), config);
+            if (!group) {
                 return false;
             }
+            group->attrs.len_bits = value.get<int>();
         } else {
             if (!value.is_object()) {
                 return false;
             }
 
             for (const auto &[key2, value2] : value.items()) {
-                if (!value2.is_number_integer()) {
+                if (!IsInt(value2)) {
                     return false;
                 }
-                config.len_bits[key][key2] = value2.get<int>();
+                config.Attrs(key, key2).len_bits = value2.get<int>();
             }
         }
     }
@@ -233,15 +244,11 @@ bool ParseSubmodule(const json &json, Config &config) {
                 auto wires_arr = value.get<json::array_t>();
 
                 if (key.length() > 0 && key[0] == '*') { // group
-                    auto group_name = key.substr(1);
-                    if (config.groups.count(group_name) && wires_arr.empty()) {
-                        for (const auto &wire : config.groups[group_name].wires) {
-                            submodule.wires.emplace_back(wire.first, wire.second);
-                        }
-                        continue;
-                    } else {
+                    auto it = config.group_ids.find(key.substr(1));
+                    if (it == config.group_ids.end() || !wires_arr.empty()) {
                         return false;
                     }
+                    submodule.groups.emplace_back(it->second);
                 } else { // normal
                     for (const auto &wire : wires_arr) {
                         if (!wire.is_string()) {
@@ -255,18 +262,31 @@ bool ParseSubmodule(const json &json, Config &config) {
             return false;
         }
 
-        if (config.submodule.count(submodule.name) || submodule.name == config.module_name) {
+        if (!config.AddSubmodule(std::move(submodule))) {
             return false;
         }
-        config.submodule[submodule.name] = submodule;
     }
 
     return true;
 }
 
+// parts of 'VgaTiming' by their names in 'vga_timing'
+const std::pair<std::string_view, int VgaTiming::*> timing_fields[] = {
+    { "h_visible", &VgaTiming::h_visible },
+    { "h_front_porch", &VgaTiming::h_front_porch },
+    { "h_sync", &VgaTiming::h_sync },
+    { "h_back_porch", &VgaTiming::h_back_porch },
+    { "v_visible", &VgaTiming::v_visible },
+    { "v_front_porch", &VgaTiming::v_front_porch },
+    { "v_sync", &VgaTiming::v_sync },
+    { "v_back_porch", &VgaTiming::v_back_porch },
+    { "h_sync_positive", &VgaTiming::h_sync_positive },
+    { "v_sync_positive", &VgaTiming::v_sync_positive },
+};
+
 }
 
-std::optional<Config> Config::From(std::ifstream &fin) {
+std::optional<Config> Config::FromDom(std::istream &fin, std::ostream &err) {
     json json;
     fin >> json;
 
@@ -328,7 +348,7 @@ std::optional<Config> Config::From(std::ifstream &fin) {
 
     if (json.contains("header_lines")) {
         auto obj = json["header_lines"];
-        if (!obj.is_number_integer()) {
+        if (!IsInt(obj)) {
             errors.emplace_back("Field 'header_lines' should be an integer");
         } else {
             config.header_lines = obj.get<int>();
@@ -336,7 +356,7 @@ std::optional<Config> Config::From(std::ifstream &fin) {
     }
     if (json.contains("template_width")) {
         auto obj = json["template_width"];
-        if (!obj.is_number_integer()) {
+        if (!IsInt(obj)) {
             errors.emplace_back("Field 'template_width' should be an integer");
         } else {
             config.template_width = obj.get<int>();
@@ -344,13 +364,132 @@ std::optional<Config> Config::From(std::ifstream &fin) {
     }
     if (json.contains("template_height")) {
         auto obj = json["template_height"];
-        if (!obj.is_number_integer()) {
+        if (!IsInt(obj)) {
             errors.emplace_back("Field 'template_height' should be an integer");
         } else {
             config.template_height = obj.get<int>();
         }
     }
 
+    if (json.contains("mem_format")) {
+        auto obj = json["mem_format"];
+        if (!obj.is_string() || !ParseMemFormat(obj.get<std::string>(), config.mem_format)) {
+            errors.emplace_back("Field 'mem_format' should be one of 'hex', 'hex_sparse', 'coe', 'mif' and 'bin'");
+        }
+    }
+    if (json.contains("mem_word_bytes")) {
+        auto obj = json["mem_word_bytes"];
+        if (!IsInt(obj) || !IsValidMemWordBytes(obj.get<int>())) {
+            errors.emplace_back("Field 'mem_word_bytes' should be 1, 2, 4 or 8");
+        } else {
+            config.mem_word_bytes = obj.get<int>();
+        }
+    }
+    if (json.contains("scan_mode")) {
+        auto obj = json["scan_mode"];
+        if (!obj.is_string() || !ParseScanMode(obj.get<std::string>(), config.scan_mode)) {
+            errors.emplace_back("Field 'scan_mode' should be 'full' or 'dynamic'");
+        }
+    }
+    if (json.contains("pipeline_stages")) {
+        auto obj = json["pipeline_stages"];
+        if (!IsInt(obj) || obj.get<int>() < 0) {
+            errors.emplace_back("Field 'pipeline_stages' should be a non-negative integer");
+        } else {
+            config.pipeline_stages = obj.get<int>();
+        }
+    }
+    if (json.contains("lanes")) {
+        auto obj = json["lanes"];
+        if (!IsInt(obj) || !IsValidLanes(obj.get<int>())) {
+            errors.emplace_back("Field 'lanes' should be 1, 2, 4 or 8");
+        } else {
+            config.lanes = obj.get<int>();
+        }
+    }
+    if (json.contains("cdc_snapshot")) {
+        auto obj = json["cdc_snapshot"];
+        if (!obj.is_boolean()) {
+            errors.emplace_back("Field 'cdc_snapshot' should be a boolean");
+        } else {
+            config.cdc_snapshot = obj.get<bool>();
+        }
+    }
+    if (json.contains("limits")) {
+        auto obj = json["limits"];
+        bool ok = obj.is_object();
+        if (ok) {
+            for (const auto &[name, value] : obj.items()) {
+                ok = ok && IsInt(value) && SetLimit(config.limits, name, value.get<int>());
+            }
+        }
+        if (!ok) {
+            errors.emplace_back("Field 'limits' should map names of limits to non-negative integers");
+        }
+    }
+    if (json.contains("vga_mode")) {
+        auto obj = json["vga_mode"];
+        VgaTiming timing;
+        if (!obj.is_string() || !ParseVgaMode(obj.get<std::string>(), timing)) {
+            errors.emplace_back("Field 'vga_mode' should be one of '640x480', '800x600', '1024x768', '1280x720' "
+                "and '1920x1080'");
+        } else {
+            config.vga_mode = obj.get<std::string>();
+        }
+    }
+    if (json.contains("vga_timing")) {
+        auto obj = json["vga_timing"];
+        bool ok = obj.is_object();
+        if (ok) {
+            for (const auto &[name, value] : obj.items()) {
+                ok = ok && IsInt(value) && SetTiming(config.vga_timing, name, value.get<int>());
+            }
+        }
+        if (!ok) {
+            errors.emplace_back("Field 'vga_timing' should map parts of the timing to non-negative integers");
+        }
+    }
+    if (json.contains("font_file")) {
+        auto obj = json["font_file"];
+        if (!obj.is_string()) {
+            errors.emplace_back("Field 'font_file' should be a string");
+        } else {
+            config.font_file = obj.get<std::string>();
+        }
+    }
+    if (json.contains("font_width")) {
+        auto obj = json["font_width"];
+        if (!IsInt(obj) || !IsValidFontWidth(obj.get<int>())) {
+            errors.emplace_back("Field 'font_width' should be 2, 4 or 8");
+        } else {
+            config.font_width = obj.get<int>();
+        }
+    }
+    if (json.contains("font_height")) {
+        auto obj = json["font_height"];
+        if (!IsInt(obj) || !IsValidFontHeight(obj.get<int>())) {
+            errors.emplace_back("Field 'font_height' should be 2, 4, 8, 16 or 32");
+        } else {
+            config.font_height = obj.get<int>();
+        }
+    }
+    if (json.contains("compact_font")) {
+        auto obj = json["compact_font"];
+        if (!obj.is_boolean()) {
+            errors.emplace_back("Field 'compact_font' should be a boolean");
+        } else {
+            config.compact_font = obj.get<bool>();
+        }
+    }
+    if (json.contains("display_pipeline")) {
+        auto obj = json["display_pipeline"];
+        if (!obj.is_boolean()) {
+            errors.emplace_back("Field 'display_pipeline' should be a boolean");
+        } else {
+            config.display_pipeline = obj.get<bool>();
+        }
+    }
+
     if (json.contains("block_prefix")) {
         auto obj = json["block_prefix"];
         if (!CheckBlockPrefix(obj)) {
@@ -407,26 +546,203 @@ std::optional<Config> Config::From(std::ifstream &fin) {
         auto obj = json["submodule"];
         if (!ParseSubmodule(obj, config)) {
             errors.emplace_back("Field 'submodule' has a wrong type or wrong group reference "
-                "or some submodules have the same name");
+                "or some submodules have the same name or some wires belong to more than one submodule");
         }
     }
 
     if (!errors.empty()) {
         for (const auto &error : errors) {
-            std::cerr << error << std::endl;
+            err << error << std::endl;
         }
         return std::nullopt;
     }
     return config;
 }
 
-std::string Config::FindSubmoduleOfWire(const std::string &block_name, const std::string &wire_name) {
-    for (const auto &[_, submodule] : submodule) {
-        for (const auto &[block, wire] : submodule.wires) {
-            if (block == block_name && wire == wire_name) {
-                return submodule.name;
+bool Config::ParseMemFormat(std::string_view name, MemFormat &format) {
+    static const std::pair<std::string_view, MemFormat> formats[] = {
+        { "hex", MemFormat::Hex },
+        { "hex_sparse", MemFormat::HexSparse },
+        { "coe", MemFormat::Coe },
+        { "mif", MemFormat::Mif },
+        { "bin", MemFormat::Bin },
+    };
+    for (const auto &[format_name, value] : formats) {
+        if (format_name == name) {
+            format = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Config::ParseScanMode(std::string_view name, ScanMode &mode) {
+    if (name == "full") {
+        mode = ScanMode::Full;
+    } else if (name == "dynamic") {
+        mode = ScanMode::Dynamic;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Config::SetLimit(Limits &limits, std::string_view name, int value) {
+    if (value < 0) {
+        return false;
+    }
+    if (name == "bram_bits") {
+        limits.bram_bits = value;
+    } else if (name == "luts") {
+        limits.luts = value;
+    } else if (name == "logic_levels") {
+        limits.logic_levels = value;
+    } else if (name == "mux_inputs") {
+        limits.mux_inputs = value;
+    } else if (name == "refresh_cycles") {
+        limits.refresh_cycles = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Config::ParseVgaMode(std::string_view name, VgaTiming &timing) {
+    // VESA and CEA-861 timings at 60 Hz
+    static const std::pair<std::string_view, VgaTiming> modes[] = {
+        { "640x480", { 640, 16, 96, 48, 480, 10, 2, 33, 0, 0 } },
+        { "800x600", { 800, 40, 128, 88, 600, 1, 4, 23, 1, 1 } },
+        { "1024x768", { 1024, 24, 136, 160, 768, 3, 6, 29, 0, 0 } },
+        { "1280x720", { 1280, 110, 40, 220, 720, 5, 5, 20, 1, 1 } },
+        { "1920x1080", { 1920, 88, 44, 148, 1080, 4, 5, 36, 1, 1 } },
+    };
+    for (const auto &[mode_name, mode] : modes) {
+        if (mode_name == name) {
+            timing = mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Config::SetTiming(VgaTiming &timing, std::string_view name, int value) {
+    for (const auto &[field_name, field] : timing_fields) {
+        if (field_name == name) {
+            bool polarity = name == "h_sync_positive" || name == "v_sync_positive";
+            if (value < 0 || (polarity && value > 1) || (!polarity && value > 65535)) {
+                return false;
             }
+            timing.*field = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Config::MergeTiming(VgaTiming &timing, const VgaTiming &overrides) {
+    bool merged = false;
+    for (const auto &[_, field] : timing_fields) {
+        if (overrides.*field >= 0) {
+            timing.*field = overrides.*field;
+            merged = true;
+        }
+    }
+    return merged;
+}
+
+void Config::IndexGroups() {
+    std::vector<int> sorted_ids(groups.size());
+    for (int i = 0; i < sorted_ids.size(); i++) {
+        sorted_ids[i] = i;
+    }
+    // the group with the greatest name first, so that it takes precedence when resolving
+    std::sort(sorted_ids.begin(), sorted_ids.end(), [&](int a, int b) { return groups[a].name > groups[b].name; });
+
+    wire_groups.clear();
+    for (int group_id : sorted_ids) {
+        for (auto wire_key : groups[group_id].wires) {
+            wire_groups[wire_key].emplace_back(group_id);
+        }
+    }
+}
+
+bool Config::AddSubmodule(Submodule new_submodule) {
+    if (submodule.count(new_submodule.name) || new_submodule.name == module_name) {
+        return false;
+    }
+    int submodule_id = strings.Intern(new_submodule.name);
+    // a wire can only belong to one submodule, but listing it twice in the same one is harmless
+    std::vector<std::pair<std::string, std::string>> wires;
+    for (auto &[block, wire] : new_submodule.wires) {
+        auto &attrs = Attrs(block, wire);
+        if (attrs.submodule == submodule_id) {
+            continue;
+        }
+        if (attrs.submodule >= 0) {
+            return false;
+        }
+        attrs.submodule = submodule_id;
+        wires.emplace_back(std::move(block), std::move(wire));
+    }
+    new_submodule.wires = std::move(wires);
+    std::vector<int> own_groups;
+    for (int group_id : new_submodule.groups) {
+        auto &attrs = groups[group_id].attrs;
+        if (attrs.submodule == submodule_id) {
+            continue;
+        }
+        if (attrs.submodule >= 0) {
+            return false;
+        }
+        attrs.submodule = submodule_id;
+        own_groups.emplace_back(group_id);
+    }
+    new_submodule.groups = std::move(own_groups);
+    auto name = new_submodule.name;
+    submodule[name] = std::move(new_submodule);
+    return true;
+}
+
+WireAttrs &Config::Attrs(std::string_view block_name, std::string_view wire_name) {
+    return wire_attrs[WireKey(strings.Intern(block_name), strings.Intern(wire_name))];
+}
+
+const WireAttrs *Config::ResolveAttrs(std::string_view block_name, std::string_view wire_name,
+    std::unordered_map<uint64_t, WireAttrs> &cache) const {
+    int block_id = strings.Find(block_name);
+    int wire_id = strings.Find(wire_name);
+    if (block_id < 0 || wire_id < 0) {
+        return nullptr;
+    }
+    auto key = WireKey(block_id, wire_id);
+    auto own_it = wire_attrs.find(key);
+    const auto *own = own_it == wire_attrs.end() ? nullptr : &own_it->second;
+    auto groups_it = wire_groups.find(key);
+    if (groups_it == wire_groups.end()) {
+        return own;
+    }
+    if (auto it = cache.find(key); it != cache.end()) {
+        return &it->second;
+    }
+
+    auto inherit = [](int &value, int group_value) {
+        if (value < 0) {
+            value = group_value;
+        }
+    };
+    WireAttrs attrs = own ? *own : WireAttrs {};
+    for (int group_id : groups_it->second) {
+        const auto &group_attrs = groups[group_id].attrs;
+        inherit(attrs.prefix, group_attrs.prefix);
+        inherit(attrs.suffix, group_attrs.suffix);
+        inherit(attrs.len_bits, group_attrs.len_bits);
+        if (group_attrs.submodule >= 0 && attrs.submodule >= 0 && attrs.submodule != group_attrs.submodule) {
+            throw "Wire '" + std::string(wire_name) + "' of block '" + std::string(block_name)
+                + "' belongs to more than one submodule ('" + std::string(strings[attrs.submodule]) + "' and '"
+                + std::string(strings[group_attrs.submodule]) + "')";
         }
+        inherit(attrs.submodule, group_attrs.submodule);
     }
-    return module_name;
+
+    return &cache.emplace(key, attrs).first->second;
 }
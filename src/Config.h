@@ -1,20 +1,74 @@
 #pragma once
 
-#include <fstream>
+#include <cstdint>
+#include <iostream>
+#include <map>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <optional>
 
+#include "StringPool.h"
+
+// All overrides of one (block, wire), strings are ids in 'Config::strings' and -1 means not set
+struct WireAttrs {
+    int prefix = -1;
+    int suffix = -1;
+    int name = -1;
+    int len_bits = -1;
+    int submodule = -1;
+};
+
 struct Group {
     std::string name;
-    std::vector<std::pair<std::string, std::string>> wires;
+    std::vector<uint64_t> wires; // 'Config::WireKey' of each wire
+    WireAttrs attrs; // set by "*name" in 'len_bits', 'wire_prefix', 'wire_suffix' and 'submodule'
 };
 
 struct Submodule {
     std::string name;
     std::string parent_name;
-    std::vector<std::pair<std::string, std::string>> wires;
+    std::vector<std::pair<std::string, std::string>> wires; // listed explicitly
+    std::vector<int> groups; // ids in 'Config::groups', their wires are not copied
+};
+
+// format of 'mem_file', the initial content of the character RAM
+enum class MemFormat {
+    Hex, // one word per line, for '$readmemh'
+    HexSparse, // the same, but runs of zero words are skipped with '@address'
+    Coe, // Xilinx coefficient file
+    Mif, // Intel memory initialization file
+    Bin, // raw bytes
+};
+
+// how the generated 'VgaDebugger' refreshes the character RAM
+enum class ScanMode {
+    Full, // steps through every cell of the screen, writing only cells of nibbles
+    Dynamic, // steps through cells of nibbles only, so the refresh period scales with the number of nibbles
+};
+
+// limits of the estimate of the generated hardware (see 'Estimate'), exceeding one is a warning, -1 for none
+struct Limits {
+    int bram_bits = -1;
+    int luts = -1;
+    int logic_levels = -1;
+    int mux_inputs = -1;
+    int refresh_cycles = -1;
+};
+
+// timing of a VGA mode in pixels and lines, -1 for the value of the mode in 'Config::vga_mode'
+struct VgaTiming {
+    int h_visible = -1;
+    int h_front_porch = -1;
+    int h_sync = -1;
+    int h_back_porch = -1;
+    int v_visible = -1;
+    int v_front_porch = -1;
+    int v_sync = -1;
+    int v_back_porch = -1;
+    int h_sync_positive = -1; // 1 if the sync pulse is high, otherwise 0
+    int v_sync_positive = -1;
 };
 
 struct Config {
@@ -30,19 +84,84 @@ struct Config {
     int template_width = 80;
     int template_height = 30;
 
+    MemFormat mem_format = MemFormat::Hex;
+    ScanMode scan_mode = ScanMode::Full;
+    int pipeline_stages = 0; // registered stages of the VgaDebugger datapath, 0 for a combinational 'case'
+    int lanes = 1; // characters written per cycle, they are in one word of the character RAM
+    // wires are sampled on their own clock and handed to the VGA clock, see 'VgaDebugGenerator::Generate_Snapshot'
+    bool cdc_snapshot = false;
+    Limits limits;
+    // the VGA controller and display are generated for this mode, with the timing overridden by 'vga_timing',
+    // if either is given, otherwise those in 'vga/' are used
+    std::string vga_mode;
+    VgaTiming vga_timing;
+    std::string font_file = "font_8x16.mem"; // read by the generated display, 'font_height' bytes per glyph
+    int font_width = 8;
+    int font_height = 16;
+    // the generated display has only the glyphs the template can show, and the character RAM holds their indices
+    // in that font instead of ASCII, see 'VgaDebugGenerator::Generate_Font'
+    bool compact_font = false;
+    // reads of the generated display are registered, and 'hs' and 'vs' pass through it to stay aligned, see
+    // 'VgaDebugGenerator::Generate_TextPixel'
+    bool display_pipeline = false;
+
+    // bytes of the character RAM packed into one word of 'mem_file', the lowest address at the lowest bits
+    int mem_word_bytes = 1;
+
     std::unordered_map<std::string, std::string> block_prefix;
-    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> wire_prefix;
     std::unordered_map<std::string, std::string> block_suffix;
-    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> wire_suffix;
-    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> wire_name;
 
-    std::unordered_map<std::string, std::unordered_map<std::string, int>> len_bits;
+    // 'wire_prefix', 'wire_suffix', 'wire_name', 'len_bits' and owners in 'submodule' of each (block, wire),
+    // keyed by 'WireKey' of the interned names
+    std::unordered_map<uint64_t, WireAttrs> wire_attrs;
+    StringPool strings; // names of blocks and wires, and string values in 'wire_attrs'
     
-    std::unordered_map<std::string, Submodule> submodule;
+    std::map<std::string, Submodule> submodule; // ordered, so that the generated code is deterministic
+
+    std::vector<Group> groups;
+    std::unordered_map<std::string, int> group_ids;
+    // groups that each wire belongs to, in descending order of their names
+    std::unordered_map<uint64_t, std::vector<int>> wire_groups;
+
+    // streams the config through a SAX parser, filling the fields directly without building a DOM
+    static std::optional<Config> From(std::istream &fin, std::ostream &err = std::cerr);
+    // the same as 'From', but builds a DOM first, which is slower and takes more memory on large configs, the
+    // unit test 'config_parity' checks that both give the same config or the same errors
+    static std::optional<Config> FromDom(std::istream &fin, std::ostream &err = std::cerr);
 
-    std::unordered_map<std::string, Group> groups;
+    static uint64_t WireKey(int block_id, int wire_id) {
+        return (static_cast<uint64_t>(block_id) << 32) | static_cast<uint32_t>(wire_id);
+    }
+    // returns false if 'name' is not a format
+    static bool ParseMemFormat(std::string_view name, MemFormat &format);
+    static bool ParseScanMode(std::string_view name, ScanMode &mode);
+    static bool IsValidMemWordBytes(int bytes) { return bytes == 1 || bytes == 2 || bytes == 4 || bytes == 8; }
+    static bool IsValidLanes(int lanes) { return IsValidMemWordBytes(lanes); }
+    // returns false if 'name' is not a limit or 'value' is negative
+    static bool SetLimit(Limits &limits, std::string_view name, int value);
+    // returns false if 'name' is not a mode, otherwise 'timing' is set to it
+    static bool ParseVgaMode(std::string_view name, VgaTiming &timing);
+    // returns false if 'name' is not a part of the timing or 'value' is out of its range
+    static bool SetTiming(VgaTiming &timing, std::string_view name, int value);
+    // copies the parts of 'overrides' which are set, returns false if there is none
+    static bool MergeTiming(VgaTiming &timing, const VgaTiming &overrides);
+    static bool IsValidFontWidth(int width) { return width == 2 || width == 4 || width == 8; }
+    static bool IsValidFontHeight(int height) {
+        return height >= 2 && height <= 32 && (height & (height - 1)) == 0;
+    }
 
-    static std::optional<Config> From(std::ifstream &fin);
+    // builds 'wire_groups' from 'groups'
+    void IndexGroups();
 
-    std::string FindSubmoduleOfWire(const std::string &block_name, const std::string &wire_name);
+    // adds a submodule and makes it the owner of its wires and groups, those listed twice in it are kept once,
+    // returns false if the name is taken or a wire or group already belongs to another submodule
+    bool AddSubmodule(Submodule new_submodule);
+    // inserts the entry if it doesn't exist
+    WireAttrs &Attrs(std::string_view block_name, std::string_view wire_name);
+    // Resolves all attributes of a wire, returns null if there is none. Attributes of the wire itself take
+    // precedence over those of its groups, and among groups the one with the greatest name wins. Results of
+    // wires which belong to groups are cached in 'cache', which is kept by the caller, so that a config can be
+    // shared between threads. Throws a message if the wire belongs to more than one submodule.
+    const WireAttrs *ResolveAttrs(std::string_view block_name, std::string_view wire_name,
+        std::unordered_map<uint64_t, WireAttrs> &cache) const;
 };
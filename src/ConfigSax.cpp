@@ -0,0 +1,576 @@
+#include "Config.h"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+enum class Field {
+    None = -1,
+    TemplateFile, OutputDir, MemFile, DbgHeader, ModuleName, HeaderLines, TemplateWidth, TemplateHeight,
+    MemFormat, MemWordBytes, ScanMode, PipelineStages, Lanes, CdcSnapshot, Limits, VgaMode, VgaTiming, FontFile,
+    FontWidth, FontHeight, CompactFont, DisplayPipeline,
+    BlockPrefix, BlockSuffix, WireGroup, LenBits, WirePrefix, WireSuffix, WireName, Submodule,
+    Count
+};
+
+struct FieldInfo {
+    std::string_view name;
+    const char *missing_error; // null if the field is optional
+    const char *wrong_error;
+};
+
+// in the order errors are reported, the same as 'Config::FromDom'
+const FieldInfo field_infos[] = {
+    { "template_file", "Can't find 'template_file', which is not optional",
+        "Field 'template_file' should be a string" },
+    { "output_dir", nullptr, "Field 'output_dir' should be a string" },
+    { "mem_file", "Can't find 'mem_file', which is not optional", "Field 'mem_file' should be a string" },
+    { "dbg_header", "Can't find 'mem_file', which is not optional", "Field 'dbg_header' should be a string" },
+    { "module_name", "Can't find 'module_name', which is not optional", "Field 'module_name' should be a string" },
+    { "header_lines", nullptr, "Field 'header_lines' should be an integer" },
+    { "template_width", nullptr, "Field 'template_width' should be an integer" },
+    { "template_height", nullptr, "Field 'template_height' should be an integer" },
+    { "mem_format", nullptr, "Field 'mem_format' should be one of 'hex', 'hex_sparse', 'coe', 'mif' and 'bin'" },
+    { "mem_word_bytes", nullptr, "Field 'mem_word_bytes' should be 1, 2, 4 or 8" },
+    { "scan_mode", nullptr, "Field 'scan_mode' should be 'full' or 'dynamic'" },
+    { "pipeline_stages", nullptr, "Field 'pipeline_stages' should be a non-negative integer" },
+    { "lanes", nullptr, "Field 'lanes' should be 1, 2, 4 or 8" },
+    { "cdc_snapshot", nullptr, "Field 'cdc_snapshot' should be a boolean" },
+    { "limits", nullptr, "Field 'limits' should map names of limits to non-negative integers" },
+    { "vga_mode", nullptr, "Field 'vga_mode' should be one of '640x480', '800x600', '1024x768', '1280x720' "
+        "and '1920x1080'" },
+    { "vga_timing", nullptr, "Field 'vga_timing' should map parts of the timing to non-negative integers" },
+    { "font_file", nullptr, "Field 'font_file' should be a string" },
+    { "font_width", nullptr, "Field 'font_width' should be 2, 4 or 8" },
+    { "font_height", nullptr, "Field 'font_height' should be 2, 4, 8, 16 or 32" },
+    { "compact_font", nullptr, "Field 'compact_font' should be a boolean" },
+    { "display_pipeline", nullptr, "Field 'display_pipeline' should be a boolean" },
+    { "block_prefix", nullptr, "Field 'block_prefix' has a wrong type" },
+    { "block_suffix", nullptr, "Field 'block_suffix' has a wrong type" },
+    { "wire_group", nullptr, "Field 'wire_group' has a wrong type or some groups have the same name" },
+    { "len_bits", nullptr, "Field 'len_bits' has a wrong type or wrong group reference" },
+    { "wire_prefix", nullptr, "Field 'wire_prefix' has a wrong type or wrong group reference" },
+    { "wire_suffix", nullptr, "Field 'wire_suffix' has a wrong type or wrong group reference" },
+    { "wire_name", nullptr, "Field 'wire_name' has a wrong type" },
+    { "submodule", nullptr, "Field 'submodule' has a wrong type or wrong group reference "
+        "or some submodules have the same name or some wires belong to more than one submodule" },
+};
+
+Field FindField(std::string_view name) {
+    for (int i = 0; i < static_cast<int>(Field::Count); i++) {
+        if (field_infos[i].name == name) {
+            return static_cast<Field>(i);
+        }
+    }
+    return Field::None;
+}
+
+// Fills a 'Config' while the JSON is being parsed, values are checked as soon as they come. Group references
+// and submodules are resolved in 'Finish', since they depend on fields which may come later in the file.
+class ConfigSax {
+public:
+    explicit ConfigSax(Config &config) : config(config) {}
+
+    // the SAX interface of nlohmann::json
+    bool null() { return Scalar(Kind::Other); }
+    bool boolean(bool value) { return Scalar(Kind::Boolean, value); }
+    // integers which don't fit in an 'int' are a wrong type, as in 'Config::FromDom'
+    bool number_integer(json::number_integer_t value) {
+        bool fits = value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max();
+        return Scalar(fits ? Kind::Integer : Kind::Other, fits ? static_cast<int>(value) : 0);
+    }
+    bool number_unsigned(json::number_unsigned_t value) {
+        bool fits = value <= static_cast<json::number_unsigned_t>(std::numeric_limits<int>::max());
+        return Scalar(fits ? Kind::Integer : Kind::Other, fits ? static_cast<int>(value) : 0);
+    }
+    bool number_float(json::number_float_t, const json::string_t &) { return Scalar(Kind::Other); }
+    bool string(json::string_t &value) { return Scalar(Kind::String, 0, &value); }
+    bool binary(json::binary_t &) { return Scalar(Kind::Other); }
+    bool start_object(std::size_t) { return Start(Kind::Object); }
+    bool start_array(std::size_t) { return Start(Kind::Array); }
+    bool end_object() { return End(); }
+    bool end_array() { return End(); }
+    bool key(json::string_t &name);
+    // the same exceptions as parsing into a DOM, thrown as their own types rather than the base
+    bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex) {
+        if (auto error = dynamic_cast<const json::parse_error *>(&ex)) {
+            throw *error;
+        }
+        if (auto error = dynamic_cast<const json::out_of_range *>(&ex)) {
+            throw *error;
+        }
+        throw std::runtime_error(ex.what());
+    }
+
+    // returns false if there is any error, and the errors are printed to 'err'
+    bool Finish(std::ostream &err);
+
+private:
+    enum class Kind { String, Integer, Boolean, Other, Object, Array };
+    enum class Action { Enter, Ignore, Wrong };
+
+    struct PendingSubmodule {
+        Submodule submodule;
+        bool has_name = false;
+        bool has_parent = false;
+        bool has_wires = false;
+        std::vector<std::string> group_names;
+    };
+
+    // "*group" in 'len_bits', 'wire_prefix' or 'wire_suffix', 'value' is a string id for the latter two
+    struct GroupRef {
+        Field field;
+        std::string group_name;
+        int value;
+    };
+
+    Config &config;
+
+    int depth = 0; // number of open objects and arrays
+    int skip_depth = 0; // number of them to be closed before values are handled again
+    Field field = Field::None;
+    // key of the value in each open object, 'keys[1]' is the name of the field, values nested deeper than the
+    // array of wires in 'wire_group' and 'submodule' are never entered
+    std::string keys[6];
+    bool seen[static_cast<int>(Field::Count)] = {};
+    bool wrong[static_cast<int>(Field::Count)] = {};
+
+    Group group; // the element of 'wire_group' being parsed
+    bool group_has_name = false;
+    bool group_has_wires = false;
+    PendingSubmodule submodule; // the element of 'submodule' being parsed
+    std::vector<PendingSubmodule> submodules;
+    std::vector<GroupRef> group_refs;
+
+    bool Scalar(Kind kind, int number = 0, const std::string *str = nullptr);
+    bool Start(Kind kind);
+    bool End();
+    // handles a value at the current depth, 'number' is only set for integers and booleans, 'str' for strings
+    Action Value(Kind kind, int number, const std::string *str);
+    Action ValueOfAttrs(Kind kind, int number, const std::string *str);
+    Action ValueOfGroup(Kind kind, const std::string *str);
+    Action ValueOfSubmodule(Kind kind, const std::string *str);
+    void SetWrong(int depth_after);
+    void EndGroup();
+    void EndSubmodule();
+    void ApplySubmodules();
+};
+
+bool ConfigSax::key(json::string_t &name) {
+    if (skip_depth > 0) {
+        return true;
+    }
+    keys[depth] = name;
+    if (depth == 1) {
+        field = FindField(name);
+    }
+    return true;
+}
+
+bool ConfigSax::Scalar(Kind kind, int number, const std::string *str) {
+    if (skip_depth > 0 || depth == 0) {
+        return true;
+    }
+    if (Value(kind, number, str) == Action::Wrong) {
+        SetWrong(depth);
+    }
+    return true;
+}
+
+bool ConfigSax::Start(Kind kind) {
+    ++depth;
+    if (skip_depth > 0) {
+        ++skip_depth;
+        return true;
+    }
+    if (depth == 1) {
+        // fields of anything other than an object are all missing
+        skip_depth = kind == Kind::Object ? 0 : 1;
+        return true;
+    }
+
+    --depth;
+    auto action = Value(kind, 0, nullptr);
+    ++depth;
+    if (action == Action::Ignore) {
+        skip_depth = 1;
+    } else if (action == Action::Wrong) {
+        SetWrong(depth);
+    }
+    return true;
+}
+
+bool ConfigSax::End() {
+    --depth;
+    if (skip_depth > 0) {
+        --skip_depth;
+        return true;
+    }
+    if (depth == 2 && field == Field::WireGroup) {
+        EndGroup();
+    } else if (depth == 2 && field == Field::Submodule) {
+        EndSubmodule();
+    }
+    return true;
+}
+
+void ConfigSax::SetWrong(int depth_after) {
+    wrong[static_cast<int>(field)] = true;
+    // the rest of the field is skipped
+    skip_depth = depth_after - 1;
+}
+
+ConfigSax::Action ConfigSax::Value(Kind kind, int number, const std::string *str) {
+    if (field == Field::None) {
+        return Action::Ignore;
+    }
+    if (depth == 1) {
+        seen[static_cast<int>(field)] = true;
+        wrong[static_cast<int>(field)] = false; // the last one wins if a field is given more than once
+    }
+
+    switch (field) {
+    case Field::TemplateFile:
+    case Field::OutputDir:
+    case Field::MemFile:
+    case Field::DbgHeader:
+    case Field::ModuleName: {
+        if (kind != Kind::String) {
+            return Action::Wrong;
+        }
+        std::string *targets[] = { &config.template_file, &config.output_dir, &config.mem_file,
+            &config.dbg_header, &config.module_name };
+        *targets[static_cast<int>(field) - static_cast<int>(Field::TemplateFile)] = *str;
+        if (field == Field::OutputDir) {
+            config.output_dir += '/';
+        }
+        return Action::Enter;
+    }
+    case Field::HeaderLines:
+    case Field::TemplateWidth:
+    case Field::TemplateHeight: {
+        if (kind != Kind::Integer) {
+            return Action::Wrong;
+        }
+        int *targets[] = { &config.header_lines, &config.template_width, &config.template_height };
+        *targets[static_cast<int>(field) - static_cast<int>(Field::HeaderLines)] = number;
+        return Action::Enter;
+    }
+    case Field::MemFormat:
+        return kind == Kind::String && Config::ParseMemFormat(*str, config.mem_format) ? Action::Enter
+            : Action::Wrong;
+    case Field::MemWordBytes:
+        if (kind != Kind::Integer || !Config::IsValidMemWordBytes(number)) {
+            return Action::Wrong;
+        }
+        config.mem_word_bytes = number;
+        return Action::Enter;
+    case Field::ScanMode:
+        return kind == Kind::String && Config::ParseScanMode(*str, config.scan_mode) ? Action::Enter
+            : Action::Wrong;
+    case Field::PipelineStages:
+        if (kind != Kind::Integer || number < 0) {
+            return Action::Wrong;
+        }
+        config.pipeline_stages = number;
+        return Action::Enter;
+    case Field::Lanes:
+        if (kind != Kind::Integer || !Config::IsValidLanes(number)) {
+            return Action::Wrong;
+        }
+        config.lanes = number;
+        return Action::Enter;
+    case Field::CdcSnapshot:
+        if (kind != Kind::Boolean) {
+            return Action::Wrong;
+        }
+        config.cdc_snapshot = number != 0;
+        return Action::Enter;
+    case Field::Limits:
+        if (depth == 1) {
+            return kind == Kind::Object ? Action::Enter : Action::Wrong;
+        }
+        return kind == Kind::Integer && Config::SetLimit(config.limits, keys[2], number) ? Action::Enter
+            : Action::Wrong;
+    case Field::VgaMode: {
+        VgaTiming timing;
+        if (kind != Kind::String || !Config::ParseVgaMode(*str, timing)) {
+            return Action::Wrong;
+        }
+        config.vga_mode = *str;
+        return Action::Enter;
+    }
+    case Field::VgaTiming:
+        if (depth == 1) {
+            return kind == Kind::Object ? Action::Enter : Action::Wrong;
+        }
+        return kind == Kind::Integer && Config::SetTiming(config.vga_timing, keys[2], number) ? Action::Enter
+            : Action::Wrong;
+    case Field::FontFile:
+        if (kind != Kind::String) {
+            return Action::Wrong;
+        }
+        config.font_file = *str;
+        return Action::Enter;
+    case Field::FontWidth:
+        if (kind != Kind::Integer || !Config::IsValidFontWidth(number)) {
+            return Action::Wrong;
+        }
+        config.font_width = number;
+        return Action::Enter;
+    case Field::FontHeight:
+        if (kind != Kind::Integer || !Config::IsValidFontHeight(number)) {
+            return Action::Wrong;
+        }
+        config.font_height = number;
+        return Action::Enter;
+    case Field::CompactFont:
+        if (kind != Kind::Boolean) {
+            return Action::Wrong;
+        }
+        config.compact_font = number != 0;
+        return Action::Enter;
+    case Field::DisplayPipeline:
+        if (kind != Kind::Boolean) {
+            return Action::Wrong;
+        }
+        config.display_pipeline = number != 0;
+        return Action::Enter;
+    case Field::BlockPrefix:
+    case Field::BlockSuffix:
+        if (depth == 1) {
+            return kind == Kind::Object ? Action::Enter : Action::Wrong;
+        }
+        if (kind != Kind::String) {
+            return Action::Wrong;
+        }
+        (field == Field::BlockPrefix ? config.block_prefix : config.block_suffix)[keys[2]] = *str;
+        return Action::Enter;
+    case Field::WireGroup:
+        return ValueOfGroup(kind, str);
+    case Field::LenBits:
+    case Field::WirePrefix:
+    case Field::WireSuffix:
+    case Field::WireName:
+        return ValueOfAttrs(kind, number, str);
+    case Field::Submodule:
+        return ValueOfSubmodule(kind, str);
+    default:
+        return Action::Ignore;
+    }
+}
+
+ConfigSax::Action ConfigSax::ValueOfAttrs(Kind kind, int number, const std::string *str) {
+    auto value_kind = field == Field::LenBits ? Kind::Integer : Kind::String;
+    if (depth == 1) {
+        return kind == Kind::Object ? Action::Enter : Action::Wrong;
+    }
+    if (depth == 2) {
+        const auto &block_name = keys[2];
+        if (field != Field::WireName && block_name.length() > 0 && block_name[0] == '*') { // group
+            if (kind != value_kind) {
+                return Action::Wrong;
+            }
+            int value = kind == Kind::Integer ? number : config.strings.Intern(*str);
+            group_refs.push_back(GroupRef { field, block_name.substr(1), value });
+            return Action::Enter;
+        }
+        return kind == Kind::Object ? Action::Enter : Action::Wrong;
+    }
+
+    if (kind != value_kind) {
+        return Action::Wrong;
+    }
+    auto &attrs = config.Attrs(keys[2], keys[3]);
+    switch (field) {
+    case Field::LenBits: attrs.len_bits = number; break;
+    case Field::WirePrefix: attrs.prefix = config.strings.Intern(*str); break;
+    case Field::WireSuffix: attrs.suffix = config.strings.Intern(*str); break;
+    default: attrs.name = config.strings.Intern(*str); break;
+    }
+    return Action::Enter;
+}
+
+ConfigSax::Action ConfigSax::ValueOfGroup(Kind kind, const std::string *str) {
+    switch (depth) {
+    case 1:
+        return kind == Kind::Array ? Action::Enter : Action::Wrong;
+    case 2:
+        if (kind != Kind::Object) {
+            return Action::Wrong;
+        }
+        group = Group {};
+        group_has_name = false;
+        group_has_wires = false;
+        return Action::Enter;
+    case 3:
+        if (keys[3] == "name") {
+            if (kind != Kind::String) {
+                return Action::Wrong;
+            }
+            group.name = *str;
+            group_has_name = true;
+            return Action::Enter;
+        }
+        if (keys[3] == "wires") {
+            group_has_wires = kind == Kind::Object;
+            return group_has_wires ? Action::Enter : Action::Wrong;
+        }
+        return Action::Ignore;
+    case 4:
+        return kind == Kind::Array ? Action::Enter : Action::Wrong;
+    default:
+        if (kind != Kind::String) {
+            return Action::Wrong;
+        }
+        group.wires.emplace_back(Config::WireKey(config.strings.Intern(keys[4]), config.strings.Intern(*str)));
+        return Action::Enter;
+    }
+}
+
+void ConfigSax::EndGroup() {
+    if (!group_has_name || !group_has_wires || config.group_ids.count(group.name)) {
+        SetWrong(depth);
+        return;
+    }
+    config.group_ids[group.name] = config.groups.size();
+    config.groups.emplace_back(std::move(group));
+}
+
+ConfigSax::Action ConfigSax::ValueOfSubmodule(Kind kind, const std::string *str) {
+    switch (depth) {
+    case 1:
+        return kind == Kind::Array ? Action::Enter : Action::Wrong;
+    case 2:
+        if (kind != Kind::Object) {
+            return Action::Wrong;
+        }
+        submodule = PendingSubmodule {};
+        return Action::Enter;
+    case 3:
+        if (keys[3] == "name" || keys[3] == "parent") {
+            if (kind != Kind::String) {
+                return Action::Wrong;
+            }
+            if (keys[3] == "name") {
+                submodule.submodule.name = *str;
+                submodule.has_name = true;
+            } else {
+                submodule.submodule.parent_name = *str;
+                submodule.has_parent = true;
+            }
+            return Action::Enter;
+        }
+        if (keys[3] == "wires") {
+            submodule.has_wires = kind == Kind::Object;
+            return submodule.has_wires ? Action::Enter : Action::Wrong;
+        }
+        return Action::Ignore;
+    case 4:
+        if (kind != Kind::Array) {
+            return Action::Wrong;
+        }
+        if (keys[4].length() > 0 && keys[4][0] == '*') { // group, the array must be empty
+            submodule.group_names.emplace_back(keys[4].substr(1));
+        }
+        return Action::Enter;
+    default:
+        if (kind != Kind::String || (keys[4].length() > 0 && keys[4][0] == '*')) {
+            return Action::Wrong;
+        }
+        submodule.submodule.wires.emplace_back(keys[4], *str);
+        return Action::Enter;
+    }
+}
+
+void ConfigSax::EndSubmodule() {
+    if (!submodule.has_name || !submodule.has_wires) {
+        SetWrong(depth);
+        return;
+    }
+    submodules.emplace_back(std::move(submodule));
+}
+
+// the same checks as 'ParseSubmodule' in 'Config::FromDom', in the order of the array
+void ConfigSax::ApplySubmodules() {
+    auto &is_wrong = wrong[static_cast<int>(Field::Submodule)];
+    for (auto &pending : submodules) {
+        auto &submodule = pending.submodule;
+        if (!pending.has_parent) {
+            submodule.parent_name = config.module_name;
+        }
+        for (const auto &group_name : pending.group_names) {
+            auto it = config.group_ids.find(group_name);
+            if (it == config.group_ids.end()) {
+                is_wrong = true;
+                return;
+            }
+            submodule.groups.emplace_back(it->second);
+        }
+
+        if (!config.AddSubmodule(std::move(submodule))) {
+            is_wrong = true;
+            return;
+        }
+    }
+}
+
+bool ConfigSax::Finish(std::ostream &err) {
+    for (const auto &ref : group_refs) {
+        auto it = config.group_ids.find(ref.group_name);
+        if (it == config.group_ids.end()) {
+            wrong[static_cast<int>(ref.field)] = true;
+            continue;
+        }
+        auto &attrs = config.groups[it->second].attrs;
+        (ref.field == Field::LenBits ? attrs.len_bits : ref.field == Field::WirePrefix ? attrs.prefix
+            : attrs.suffix) = ref.value;
+    }
+    if (!wrong[static_cast<int>(Field::Submodule)]) {
+        ApplySubmodules();
+    }
+    config.IndexGroups();
+    if (!seen[static_cast<int>(Field::OutputDir)]) {
+        config.output_dir = "./";
+    }
+
+    bool ok = true;
+    for (int i = 0; i < static_cast<int>(Field::Count); i++) {
+        const char *error = nullptr;
+        if (!seen[i]) {
+            error = field_infos[i].missing_error;
+        } else if (wrong[i]) {
+            error = field_infos[i].wrong_error;
+        }
+        if (error) {
+            err << error << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+}
+
+std::optional<Config> Config::From(std::istream &fin, std::ostream &err) {
+    Config config {};
+    ConfigSax sax(config);
+    // not strict, like 'operator>>' used by 'FromDom', which ignores anything after the config
+    json::sax_parse(fin, &sax, json::input_format_t::json, false);
+    if (!sax.Finish(err)) {
+        return std::nullopt;
+    }
+    return config;
+}
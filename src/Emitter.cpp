@@ -0,0 +1,48 @@
+#include "Emitter.h"
+
+#include <charconv>
+#include <fstream>
+
+Emitter::Emitter(size_t reserve_size) : start(std::chrono::steady_clock::now()) {
+    buffer.reserve(reserve_size);
+}
+
+Emitter &Emitter::operator<<(std::string_view str) {
+    buffer.append(str);
+    return *this;
+}
+
+Emitter &Emitter::operator<<(char ch) {
+    buffer.push_back(ch);
+    return *this;
+}
+
+Emitter &Emitter::operator<<(int value) {
+    char digits[16];
+    auto [end, _] = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, end);
+    return *this;
+}
+
+void Emitter::Hex(uint64_t value, int width) {
+    static const char hex_digits[] = "0123456789abcdef";
+    for (int i = width - 1; i >= 0; i--) {
+        buffer.push_back(hex_digits[(value >> (i * 4)) & 0xf]);
+    }
+}
+
+double Emitter::ElapsedMs() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool Emitter::WriteTo(const std::string &path) const {
+    std::ofstream fout;
+    // unbuffered, so the whole content goes to the file in one write
+    fout.rdbuf()->pubsetbuf(nullptr, 0);
+    fout.open(path, std::ios::binary);
+    if (!fout) {
+        return false;
+    }
+    fout.write(buffer.data(), buffer.size());
+    return static_cast<bool>(fout);
+}
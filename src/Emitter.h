@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Builds a whole output file in memory so that it can be written with a single call.
+class Emitter {
+public:
+    explicit Emitter(size_t reserve_size = 0);
+
+    Emitter &operator<<(std::string_view str);
+    Emitter &operator<<(const char *str) { return *this << std::string_view(str); }
+    Emitter &operator<<(const std::string &str) { return *this << std::string_view(str); }
+    Emitter &operator<<(char ch);
+    Emitter &operator<<(int value);
+
+    // appends 'value' as 'width' lowercase hex digits
+    void Hex(uint64_t value, int width);
+
+    const std::string &Buffer() const { return buffer; }
+    // moves the content out, leaving the emitter empty
+    std::string TakeBuffer() { return std::move(buffer); }
+    size_t Size() const { return buffer.size(); }
+    // time since the emitter is created, in milliseconds
+    double ElapsedMs() const;
+
+    bool WriteTo(const std::string &path) const;
+
+private:
+    std::string buffer;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,58 @@
+#include "Estimate.h"
+
+#include <algorithm>
+#include <iomanip>
+
+void Estimate::Print(std::ostream &out, StatsFormat format) const {
+    if (format == StatsFormat::Json) {
+        // in one line, so that it is easy to pick from other messages
+        out << "{\"char_ram_bits\": " << char_ram_bits << ", \"font_rom_bits\": " << font_rom_bits
+            << ", \"bram_bits\": " << bram_bits << ", \"bram_blocks\": " << bram_blocks << ", \"mux_inputs\": "
+            << mux_inputs << ", \"mux_select_bits\": " << mux_select_bits << ", \"mux_width\": " << mux_width
+            << ", \"logic_levels\": " << logic_levels << ", \"luts\": " << luts << ", \"ffs\": " << ffs
+            << ", \"refresh_cycles\": " << refresh_cycles << ", \"modules\": [";
+        for (int i = 0; i < modules.size(); i++) {
+            out << (i > 0 ? ", " : "") << "{\"name\": " << JsonString(modules[i].name) << ", \"depth\": "
+                << modules[i].depth << ", \"wires\": " << modules[i].wires << ", \"port_bits\": "
+                << modules[i].port_bits << "}";
+        }
+        out << "], \"wires\": [";
+        for (int i = 0; i < wires.size(); i++) {
+            out << (i > 0 ? ", " : "") << "{\"name\": " << JsonString(wires[i].name) << ", \"page\": "
+                << wires[i].page << ", \"refresh_cycles\": " << wires[i].refresh_cycles << "}";
+        }
+        out << "], \"warnings\": [";
+        for (int i = 0; i < warnings.size(); i++) {
+            out << (i > 0 ? ", " : "") << JsonString(warnings[i]);
+        }
+        out << "]}" << std::endl;
+    } else if (format == StatsFormat::Text) {
+        out << "Estimate:" << std::endl;
+        out << "  " << std::left << std::setw(16) << "Character RAM" << std::right << std::setw(12)
+            << char_ram_bits << " bits" << std::endl;
+        out << "  " << std::left << std::setw(16) << "Font ROM" << std::right << std::setw(12) << font_rom_bits
+            << " bits" << std::endl;
+        out << "  " << std::left << std::setw(16) << "Block RAM" << std::right << std::setw(12) << bram_bits
+            << " bits in " << bram_blocks << " block(s)" << std::endl;
+        out << "  " << std::left << std::setw(16) << "Scan mux" << std::right << std::setw(12) << mux_inputs
+            << " inputs, " << mux_select_bits << " select bits, " << mux_width << " bits wide" << std::endl;
+        out << "  " << std::left << std::setw(16) << "Logic" << std::right << std::setw(12) << luts << " LUTs, "
+            << ffs << " FFs, " << logic_levels << " logic levels" << std::endl;
+        out << "  " << std::left << std::setw(16) << "Refresh" << std::right << std::setw(12) << refresh_cycles
+            << " cycles at worst" << std::endl;
+        out << "Ports:" << std::endl;
+        for (const auto &module : modules) {
+            out << "  " << std::string(module.depth * 2, ' ') << std::left
+                << std::setw(std::max(24 - module.depth * 2, 1)) << module.name << std::right << std::setw(8)
+                << module.wires << " wires" << std::setw(8) << module.port_bits << " bits" << std::endl;
+        }
+        out << "Refresh latency:" << std::endl;
+        for (const auto &wire : wires) {
+            out << "  " << std::left << std::setw(24) << wire.name << std::right << " page " << std::setw(3)
+                << wire.page << std::setw(12) << wire.refresh_cycles << " cycles" << std::endl;
+        }
+        for (const auto &warning : warnings) {
+            out << "Warning: " << warning << std::endl;
+        }
+    }
+}
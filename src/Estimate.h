@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Stats.h"
+
+struct ModuleEstimate {
+    std::string name;
+    int depth; // 0 for the top module
+    int wires; // wires passed through the ports of the module, including those of its submodules
+    int port_bits;
+};
+
+struct WireEstimate {
+    std::string name;
+    int page;
+    int refresh_cycles; // worst cycles of 'clk' from a change of the wire until all its characters are written
+};
+
+// Static estimate of the generated hardware from the resolved modules and wires, without synthesis. LUTs and
+// logic levels assume 6-input LUTs, and block RAMs are 36 Kb blocks of which 32 Kb hold data.
+struct Estimate {
+    int char_ram_bits = 0;
+    int font_rom_bits = 0;
+    int bram_bits = 0;
+    int bram_blocks = 0;
+    int mux_inputs = 0; // arms of the scan 'case', or leaves of the pipelined tree
+    int mux_select_bits = 0;
+    int mux_width = 0; // bits selected by each arm
+    int logic_levels = 0; // LUTs on the longest path between registers of VgaDebugger
+    int luts = 0; // of VgaDebugger, the port plumbing is only wiring
+    int ffs = 0;
+    int refresh_cycles = 0; // the worst of 'wires'
+    std::vector<ModuleEstimate> modules; // in a pre-order walk of the hierarchy
+    std::vector<WireEstimate> wires;
+    std::vector<std::string> warnings; // exceeded 'Config::limits' and a '.mem' file VgaDisplay can't load
+
+    void Print(std::ostream &out, StatsFormat format) const;
+};
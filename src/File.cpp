@@ -0,0 +1,15 @@
+#include "File.h"
+
+#include <fstream>
+#include <sstream>
+
+bool ReadFile(const std::string &path, std::string &content) {
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin) {
+        return false;
+    }
+    std::ostringstream sout;
+    sout << fin.rdbuf();
+    content = std::move(sout).str();
+    return true;
+}
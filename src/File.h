@@ -0,0 +1,5 @@
+#pragma once
+
+#include <string>
+
+bool ReadFile(const std::string &path, std::string &content);
@@ -0,0 +1,17 @@
+#include "Hash.h"
+
+uint64_t HashBytes(std::string_view data, uint64_t hash) {
+    for (unsigned char ch : data) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t HashValue(uint64_t value, uint64_t hash) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// 64-bit FNV-1a, pass the result of a previous call as 'hash' to hash several pieces of data together
+uint64_t HashBytes(std::string_view data, uint64_t hash = 14695981039346656037ull);
+uint64_t HashValue(uint64_t value, uint64_t hash = 14695981039346656037ull);
@@ -0,0 +1,59 @@
+#include "MappedFile.h"
+
+#include "File.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VGA_DBG_HAS_MMAP
+#endif
+
+MappedFile::~MappedFile() {
+#ifdef VGA_DBG_HAS_MMAP
+    if (mapped) {
+        munmap(const_cast<char *>(data), size);
+    }
+#endif
+}
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::string &path) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->name = path;
+#ifdef VGA_DBG_HAS_MMAP
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            file->data = static_cast<const char *>(addr);
+            file->size = st.st_size;
+            file->mapped = true;
+        }
+    }
+    close(fd);
+    if (file->mapped) {
+        return file;
+    }
+#endif
+    // empty files, special files and platforms without mmap
+    if (!ReadFile(path, file->content)) {
+        return nullptr;
+    }
+    file->data = file->content.data();
+    file->size = file->content.size();
+    return file;
+}
+
+std::shared_ptr<const MappedFile> MappedFile::FromString(std::string content, const std::string &name) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->name = name;
+    file->content = std::move(content);
+    file->data = file->content.data();
+    file->size = file->content.size();
+    return file;
+}
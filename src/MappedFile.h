@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Read-only content of a whole file, memory-mapped where it is supported. The content never moves, so views
+// into it stay valid as long as the object is alive.
+class MappedFile {
+public:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    // returns null if the file can't be opened
+    static std::shared_ptr<const MappedFile> Open(const std::string &path);
+    // wraps content that is already in memory, 'name' is used in diagnostics
+    static std::shared_ptr<const MappedFile> FromString(std::string content, const std::string &name = "<string>");
+
+    std::string_view View() const { return std::string_view(data, size); }
+    const std::string &Name() const { return name; }
+
+private:
+    MappedFile() = default;
+
+    std::string name;
+    const char *data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::string content; // used if the file is not mapped
+};
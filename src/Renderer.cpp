@@ -0,0 +1,356 @@
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+int HexDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+uint32_t Crc32(const unsigned char *data, size_t size, uint32_t crc = 0) {
+    static const auto table = []() {
+        std::vector<uint32_t> table(256);
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        return table;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void PutBigEndian(std::vector<unsigned char> &out, uint32_t value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+void WritePngChunk(std::ostream &out, const char *type, const std::vector<unsigned char> &data) {
+    std::vector<unsigned char> chunk;
+    chunk.reserve(data.size() + 12);
+    PutBigEndian(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    PutBigEndian(chunk, Crc32(chunk.data() + 4, data.size() + 4));
+    out.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+}
+
+}
+
+FrameRenderer::FrameRenderer(std::vector<unsigned char> image, RenderLayout layout, std::vector<RenderWire> wires,
+    std::vector<unsigned char> font)
+    : cells(std::move(image)), layout(layout), wires(std::move(wires)) {
+    for (int i = 0; i < this->wires.size(); i++) {
+        wire_ids[this->wires[i].name].emplace_back(i);
+    }
+    // the last page may be cut after its last row
+    cells.resize(static_cast<size_t>(layout.page_size) * layout.page_count, 0);
+    font.resize(256 * layout.font_height, 0);
+    glyph_pixels.resize(font.size() * layout.font_width);
+    for (size_t i = 0; i < font.size(); i++) {
+        for (int x = 0; x < layout.font_width; x++) {
+            glyph_pixels[i * layout.font_width + x] = font[i] >> (7 - x) & 1 ? 255 : 0;
+        }
+    }
+    pixels.resize(static_cast<size_t>(PixelWidth()) * PixelHeight(), 0);
+    rendered.resize(static_cast<size_t>(layout.width) * layout.height, 0);
+}
+
+std::optional<std::vector<unsigned char>> FrameRenderer::LoadFont(const std::string &path) {
+    std::ifstream fin(path);
+    if (!fin) {
+        return std::nullopt;
+    }
+    std::vector<unsigned char> font;
+    std::string line;
+    while (std::getline(fin, line) && font.size() < 256 * 32) {
+        if (line.empty() || line[0] == '/' || line[0] == '@') {
+            continue; // comments and addresses are not used by fonts in 'vga/'
+        }
+        int hi = HexDigit(line[0]);
+        int lo = line.size() > 1 ? HexDigit(line[1]) : -1;
+        if (hi < 0) {
+            return std::nullopt;
+        }
+        font.push_back(lo < 0 ? hi : hi * 16 + lo);
+    }
+    return font;
+}
+
+bool FrameRenderer::SetValue(std::string_view name, uint64_t value) {
+    auto it = wire_ids.find(name);
+    if (it == wire_ids.end()) {
+        return false;
+    }
+    std::vector<unsigned char> nibbles(16);
+    for (int i = 0; i < 16; i++) {
+        nibbles[i] = value >> (i * 4) & 0xf;
+    }
+    for (int id : it->second) {
+        SetNibbles(wires[id], nibbles);
+    }
+    return true;
+}
+
+bool FrameRenderer::SetValue(std::string_view name, std::string_view hex) {
+    auto it = wire_ids.find(name);
+    if (it == wire_ids.end()) {
+        return false;
+    }
+    std::vector<unsigned char> nibbles;
+    for (auto c = hex.rbegin(); c != hex.rend(); ++c) {
+        if (*c == '_') {
+            continue;
+        }
+        int digit = HexDigit(*c);
+        if (digit < 0) {
+            return false;
+        }
+        nibbles.push_back(digit);
+    }
+    for (int id : it->second) {
+        SetNibbles(wires[id], nibbles);
+    }
+    return true;
+}
+
+void FrameRenderer::SetNibbles(const RenderWire &wire, const std::vector<unsigned char> &nibbles) {
+    auto bit = [&](int b) { return b / 4 < nibbles.size() && (nibbles[b / 4] >> (b % 4) & 1); };
+    if (wire.format == WireFormat::Binary) {
+        for (int i = 0; i < wire.len_hex; i++) {
+            cells[wire.cell + i] = bit(wire.len_hex - 1 - i) ? '1' : '0';
+        }
+        return;
+    }
+    if (wire.format != WireFormat::Hex) {
+        // the same digits as 'Bin2Dec', padded with zeros
+        const int size = (wire.len_bits + 3) / 4;
+        std::vector<unsigned char> value(size, 0);
+        for (int b = 0; b < wire.len_bits; b++) {
+            value[b / 4] |= bit(b) << (b % 4);
+        }
+        const bool neg = wire.format == WireFormat::Signed && bit(wire.len_bits - 1);
+        if (neg) {
+            // the magnitude is the two's complement in 'len_bits' bits
+            int carry = 1;
+            for (int j = 0; j < size; j++) {
+                int bits = std::min(4, wire.len_bits - j * 4);
+                int sum = (~value[j] & ((1 << bits) - 1)) + carry;
+                value[j] = sum & ((1 << bits) - 1);
+                carry = sum >> bits;
+            }
+        }
+        const int first = wire.format == WireFormat::Signed ? 1 : 0;
+        if (first) {
+            cells[wire.cell] = neg ? '-' : ' ';
+        }
+        for (int i = wire.len_hex - 1; i >= first; i--) {
+            int rem = 0;
+            for (int j = size - 1; j >= 0; j--) {
+                int curr = rem * 16 + value[j];
+                value[j] = curr / 10;
+                rem = curr % 10;
+            }
+            cells[wire.cell + i] = '0' + rem;
+        }
+        return;
+    }
+    // the same bits as 'VgaDebugGenerator::Generate_Nibble' and characters as 'Hex2Ascii'
+    for (int i = 0; i < wire.len_hex; i++) {
+        int lb = std::min(wire.len_bits, (wire.len_hex - i) * 4) - 1;
+        int rb = std::min(wire.len_bits, (wire.len_hex - i - 1) * 4);
+        int value = 0;
+        if (lb >= rb && rb / 4 < nibbles.size()) {
+            value = nibbles[rb / 4] & ((1 << (lb - rb + 1)) - 1);
+        }
+        cells[wire.cell + i] = "0123456789abcdef"[value];
+    }
+}
+
+bool FrameRenderer::SetPage(int page) {
+    if (page < 0 || page >= layout.page_count) {
+        return false;
+    }
+    this->page = page;
+    return true;
+}
+
+bool FrameRenderer::Apply(std::string_view line, std::string &error) {
+    size_t pos = 0;
+    while (pos < line.size()) {
+        if (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r') {
+            ++pos;
+            continue;
+        }
+        size_t end = line.find_first_of(" \t\r", pos);
+        auto token = line.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        pos = end == std::string_view::npos ? line.size() : end;
+
+        auto eq = token.find('=');
+        if (eq == std::string_view::npos || eq == 0 || eq + 1 == token.size()) {
+            error = "'" + std::string(token) + "' should be 'name=hex' or 'page=N'";
+            return false;
+        }
+        auto name = token.substr(0, eq);
+        auto value = token.substr(eq + 1);
+        if (name == "page") {
+            int page = 0;
+            for (char c : value) {
+                page = c >= '0' && c <= '9' && page < layout.page_count ? page * 10 + (c - '0')
+                    : layout.page_count;
+            }
+            if (!SetPage(page)) {
+                error = "Page '" + std::string(value) + "' is out of range";
+                return false;
+            }
+        } else if (!wire_ids.count(name)) {
+            error = "Can't find wire '" + std::string(name) + "'";
+            return false;
+        } else if (!SetValue(name, value)) {
+            error = "Value of wire '" + std::string(name) + "' should be hex digits";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string FrameRenderer::Grid() const {
+    std::string grid;
+    grid.reserve((layout.width + 1) * layout.height);
+    const auto *page_cells = cells.data() + static_cast<size_t>(page) * layout.page_size;
+    for (int row = 0; row < layout.height; row++) {
+        for (int col = 0; col < layout.width; col++) {
+            unsigned char c = page_cells[row * layout.row_stride + col];
+            grid += c >= 0x20 && c < 0x7f ? static_cast<char>(c) : ' ';
+        }
+        grid += '\n';
+    }
+    return grid;
+}
+
+const std::vector<unsigned char> &FrameRenderer::Pixels() {
+    const auto *page_cells = cells.data() + static_cast<size_t>(page) * layout.page_size;
+    const bool all = rendered_page != page;
+    const int pixel_width = PixelWidth();
+    const int font_width = layout.font_width;
+    const int font_height = layout.font_height;
+    for (int row = 0; row < layout.height; row++) {
+        for (int col = 0; col < layout.width; col++) {
+            int index = row * layout.width + col;
+            unsigned char c = page_cells[row * layout.row_stride + col];
+            if (!all && rendered[index] == c) {
+                continue;
+            }
+            rendered[index] = c;
+            auto *dest = pixels.data() + static_cast<size_t>(row) * font_height * pixel_width + col * font_width;
+            const auto *glyph = glyph_pixels.data() + static_cast<size_t>(c) * font_height * font_width;
+            for (int y = 0; y < font_height; y++) {
+                std::memcpy(dest + static_cast<size_t>(y) * pixel_width, glyph + y * font_width, font_width);
+            }
+        }
+    }
+    rendered_page = page;
+    return pixels;
+}
+
+void FrameRenderer::Write(std::ostream &out, FrameFormat format) {
+    switch (format) {
+    case FrameFormat::Txt:
+        out << Grid();
+        break;
+    case FrameFormat::Ppm:
+        WritePpm(out);
+        break;
+    case FrameFormat::Png:
+        WritePng(out);
+        break;
+    }
+}
+
+void FrameRenderer::WritePpm(std::ostream &out) {
+    const auto &gray = Pixels();
+    std::vector<unsigned char> rgb(gray.size() * 3);
+    for (size_t i = 0; i < gray.size(); i++) {
+        rgb[i * 3] = rgb[i * 3 + 1] = rgb[i * 3 + 2] = gray[i];
+    }
+    out << "P6\n" << PixelWidth() << " " << PixelHeight() << "\n255\n";
+    out.write(reinterpret_cast<const char *>(rgb.data()), rgb.size());
+}
+
+void FrameRenderer::WritePng(std::ostream &out) {
+    const auto &gray = Pixels();
+    const int pixel_width = PixelWidth();
+    const int pixel_height = PixelHeight();
+
+    // pixels are either black or white, so rows are 1-bit grayscale, each after a filter byte of 0
+    const size_t row_bytes = 1 + (pixel_width + 7) / 8;
+    std::vector<unsigned char> raw(row_bytes * pixel_height, 0);
+    for (int y = 0; y < pixel_height; y++) {
+        auto *row = raw.data() + y * row_bytes + 1;
+        const auto *src = gray.data() + static_cast<size_t>(y) * pixel_width;
+        for (int x = 0; x < pixel_width; x++) {
+            row[x / 8] |= (src[x] & 1) << (7 - x % 8);
+        }
+    }
+
+    // a zlib stream of stored (uncompressed) deflate blocks, which is fast and needs no library
+    std::vector<unsigned char> idat = { 0x78, 0x01 };
+    idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    for (size_t pos = 0; pos < raw.size() || pos == 0;) {
+        size_t size = std::min<size_t>(raw.size() - pos, 65535);
+        bool last = pos + size == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(size & 0xff);
+        idat.push_back(size >> 8);
+        idat.push_back(~size & 0xff);
+        idat.push_back((~size >> 8) & 0xff);
+        idat.insert(idat.end(), raw.begin() + pos, raw.begin() + pos + size);
+        pos += size;
+        if (last) {
+            break;
+        }
+    }
+    uint32_t a = 1, b = 0;
+    for (size_t pos = 0; pos < raw.size();) {
+        // the sums can't overflow in 5552 bytes
+        size_t end = std::min(raw.size(), pos + 5552);
+        for (; pos < end; pos++) {
+            a += raw[pos];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    PutBigEndian(idat, b << 16 | a);
+
+    std::vector<unsigned char> ihdr;
+    PutBigEndian(ihdr, pixel_width);
+    PutBigEndian(ihdr, pixel_height);
+    ihdr.insert(ihdr.end(), { 1, 0, 0, 0, 0 }); // 1-bit grayscale, no interlace
+
+    static const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    out.write(reinterpret_cast<const char *>(signature), sizeof(signature));
+    WritePngChunk(out, "IHDR", ihdr);
+    WritePngChunk(out, "IDAT", idat);
+    WritePngChunk(out, "IEND", {});
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Wire.h"
+
+enum class FrameFormat {
+    Txt, // the character grid
+    Ppm,
+    Png,
+};
+
+// a wire as it is displayed, see 'Wire'
+struct RenderWire {
+    std::string name; // 'Wire::full_name', the name of the port of VgaDebugger
+    int len_hex;
+    int len_bits;
+    int cell; // index of the first character in the character RAM, including the page
+    WireFormat format = WireFormat::Hex;
+};
+
+// where characters are in the character RAM and how large they are on the screen
+struct RenderLayout {
+    int width; // characters of a row
+    int height;
+    int row_stride; // characters between rows in the RAM
+    int page_size; // characters between pages in the RAM
+    int page_count;
+    int font_width = 8; // pixels of a glyph, each row of it is a byte with the leftmost pixel at the highest bit
+    int font_height = 16;
+};
+
+// Software model of the generated VgaDebugger and VgaDisplay in the steady state, after a scan has written
+// the current values. Only characters of changed wires are rewritten and only changed cells are re-rendered,
+// so that thousands of frames can be rendered per second.
+class FrameRenderer {
+public:
+    // 'image' is the initial content of the character RAM, and 'font' is 'font_height' rows of each of 256
+    // characters
+    FrameRenderer(std::vector<unsigned char> image, RenderLayout layout, std::vector<RenderWire> wires,
+        std::vector<unsigned char> font);
+
+    // reads a font such as 'vga/font_8x16.mem', one hex byte per line
+    static std::optional<std::vector<unsigned char>> LoadFont(const std::string &path);
+
+    // all wires named 'name' are set, returns false if there is none
+    bool SetValue(std::string_view name, uint64_t value);
+    // 'hex' may be longer than 16 digits, '_' is ignored, returns false if there is no such wire or a digit
+    // is not hex
+    bool SetValue(std::string_view name, std::string_view hex);
+    // returns false if 'page' is out of range
+    bool SetPage(int page);
+    // one line of a value trace: space separated 'name=hex' and 'page=N', returns false with 'error' set if
+    // anything is wrong
+    bool Apply(std::string_view line, std::string &error);
+
+    // lines of the current page, each ends with a line break, and characters which aren't printable are spaces
+    std::string Grid() const;
+    // pixels of the glyph of each character of the current page, 0 or 255 for each pixel, in rows
+    const std::vector<unsigned char> &Pixels();
+    int PixelWidth() const { return layout.width * layout.font_width; }
+    int PixelHeight() const { return layout.height * layout.font_height; }
+
+    void Write(std::ostream &out, FrameFormat format);
+
+private:
+    std::vector<unsigned char> cells; // the character RAM
+    RenderLayout layout;
+    int page = 0;
+    std::vector<RenderWire> wires;
+    std::unordered_map<std::string_view, std::vector<int>> wire_ids; // views into names of 'wires'
+    // 'font_width' pixels of each row of each character, one byte per pixel, which are the highest bits of the
+    // row in the font as the generated display reads them
+    std::vector<unsigned char> glyph_pixels;
+
+    std::vector<unsigned char> pixels;
+    std::vector<unsigned char> rendered; // characters in 'pixels', of 'rendered_page', by their positions
+    int rendered_page = -1;
+
+    // 'nibbles' from the least significant one, shown in the format of 'wire'
+    void SetNibbles(const RenderWire &wire, const std::vector<unsigned char> &nibbles);
+    void WritePpm(std::ostream &out);
+    void WritePng(std::ostream &out);
+};
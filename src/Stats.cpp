@@ -0,0 +1,67 @@
+#include "Stats.h"
+
+#include <iomanip>
+
+#include "nlohmann/json.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+void Stats::Print(std::ostream &out, StatsFormat format) const {
+    auto flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+    if (format == StatsFormat::Json) {
+        // in one line, so that it is easy to pick from other messages
+        out << "{\"phases\": [";
+        for (int i = 0; i < phases.size(); i++) {
+            out << (i > 0 ? ", " : "") << "{\"name\": " << JsonString(phases[i].name) << ", \"ms\": "
+                << phases[i].ms << ", \"peak_rss_kb\": " << phases[i].peak_rss_kb << "}";
+        }
+        out << "], \"outputs\": [";
+        for (int i = 0; i < outputs.size(); i++) {
+            out << (i > 0 ? ", " : "") << "{\"file\": " << JsonString(outputs[i].file_name) << ", \"bytes\": "
+                << outputs[i].bytes << ", \"written\": " << (outputs[i].written ? "true" : "false")
+                << ", \"ms\": " << outputs[i].ms << "}";
+        }
+        out << "], \"modules\": " << modules << ", \"wires\": " << wires << ", \"nibbles\": " << nibbles
+            << ", \"case_arms\": " << case_arms << ", \"pipeline_stages\": " << pipeline_stages
+            << ", \"macro_lines\": " << macro_lines << "}" << std::endl;
+    } else if (format == StatsFormat::Text) {
+        out << "Phases:" << std::endl;
+        for (const auto &phase : phases) {
+            out << "  " << std::left << std::setw(16) << phase.name << std::right << std::setw(12) << phase.ms
+                << " ms" << std::setw(12) << phase.peak_rss_kb << " KiB peak" << std::endl;
+        }
+        out << "Outputs:" << std::endl;
+        for (const auto &output : outputs) {
+            out << "  " << std::left << std::setw(24) << output.file_name << std::right << std::setw(12)
+                << output.bytes << " bytes" << std::setw(12) << output.ms << " ms"
+                << (output.written ? "" : " (unchanged)") << std::endl;
+        }
+        out << "Modules: " << modules << ", wires: " << wires << ", nibbles: " << nibbles << ", case arms: "
+            << case_arms << ", pipeline stages: " << pipeline_stages << ", macro lines: " << macro_lines
+            << std::endl;
+    }
+    out.flags(flags);
+}
+
+long PeakRssKb() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // in bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+std::string JsonString(std::string_view value) {
+    return nlohmann::json(value).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class StatsFormat {
+    None,
+    Text,
+    Json,
+};
+
+struct PhaseStats {
+    std::string name;
+    double ms;
+    long peak_rss_kb; // peak memory of the process after this phase
+};
+
+struct OutputStats {
+    std::string file_name;
+    size_t bytes;
+    bool written; // false if it is not rewritten since the content is not changed
+    double ms;
+};
+
+// Statistics of one run of the generator
+struct Stats {
+    std::vector<PhaseStats> phases;
+    std::vector<OutputStats> outputs;
+    int modules = 0;
+    int wires = 0;
+    int nibbles = 0;
+    int case_arms = 0; // arms of the 'case (display_addr)' in VgaDebugger
+    int pipeline_stages = 0; // registered stages of the VgaDebugger datapath
+    int macro_lines = 0; // lines of macros in the debug header
+
+    void Print(std::ostream &out, StatsFormat format) const;
+};
+
+// returns 0 if it is not supported on this platform
+long PeakRssKb();
+
+// 'value' as a quoted JSON string, escaped, and with bytes which aren't UTF-8 replaced
+std::string JsonString(std::string_view value);
@@ -0,0 +1,16 @@
+#include "StringPool.h"
+
+int StringPool::Intern(std::string_view str) {
+    if (auto it = ids.find(str); it != ids.end()) {
+        return it->second;
+    }
+    int id = static_cast<int>(strings.size());
+    const auto &stored = strings.emplace_back(str);
+    ids.emplace(stored, id);
+    return id;
+}
+
+int StringPool::Find(std::string_view str) const {
+    auto it = ids.find(str);
+    return it == ids.end() ? -1 : it->second;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Stores every distinct string once. Interned strings never move, so views and ids stay valid
+// as long as the pool (or the object it was moved into) is alive.
+class StringPool {
+public:
+    StringPool() = default;
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+    StringPool(StringPool &&) = default;
+    StringPool &operator=(StringPool &&) = default;
+
+    int Intern(std::string_view str);
+    // returns -1 if 'str' has not been interned
+    int Find(std::string_view str) const;
+
+    std::string_view operator[](int id) const { return strings[id]; }
+    int Size() const { return static_cast<int>(strings.size()); }
+
+private:
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, int> ids;
+};
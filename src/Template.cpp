@@ -2,84 +2,152 @@
 
 #include <iostream>
 #include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <vector>
 
+#include "Hash.h"
+
 namespace {
 
-std::string Trim(const std::string &str, char ch = ' ') {
+std::string_view Trim(std::string_view str, char ch = ' ') {
     auto l_index = str.find_first_not_of(ch);
-    if (l_index == std::string::npos) {
+    if (l_index == std::string_view::npos) {
         l_index = 0;
     }
     auto r_index = str.find_last_not_of(ch);
-    if (r_index == std::string::npos) {
+    if (r_index == std::string_view::npos) {
         r_index = str.size() - 1;
     }
     return str.substr(l_index, r_index - l_index + 1);
 }
 
+// the format of a placeholder at 'pos', 'Hex' if there isn't a decimal or binary one
+WireFormat PlaceholderAt(std::string_view line, size_t pos) {
+    if (pos < line.size() && line[pos] == '#') {
+        return WireFormat::Unsigned;
+    }
+    if (pos + 1 < line.size() && line[pos] == '-' && line[pos + 1] == '#') {
+        return WireFormat::Signed;
+    }
+    if (pos < line.size() && line[pos] == 'b') {
+        // a run of 'b' as a whole word, so that text after the colon isn't taken as one
+        auto end = line.find_first_not_of('b', pos);
+        if (end == std::string_view::npos || line[end] == ' ') {
+            return WireFormat::Binary;
+        }
+    }
+    return WireFormat::Hex;
+}
+
+std::string Location(const MappedFile &source, int lineno, int column) {
+    return source.Name() + ":" + std::to_string(lineno) + ":" + std::to_string(column) + ": ";
+}
+
 }
 
-std::optional<Template> Template::From(std::ifstream &fin, int header_lines, int width, int height) {
+std::optional<Template> Template::From(std::shared_ptr<const MappedFile> source, int header_lines, int width,
+    int height, std::ostream &err) {
     std::vector<std::string> errors;
 
     Template templte {};
-    std::string line;
-    int max_width = 0;
+    templte.source = source;
+    templte.pages.emplace_back();
+    const auto content = source->View();
+    size_t pos = 0;
+    int lineno = 0; // in the file
+    int row = 0; // in the current page
+    // returns the next line without its line break, or an empty view at the end of file
+    auto next_line = [&](std::string_view &line) {
+        if (pos >= content.size()) {
+            line = std::string_view();
+            return false;
+        }
+        auto end = content.find('\n', pos);
+        if (end == std::string_view::npos) {
+            end = content.size();
+        }
+        line = content.substr(pos, end - pos);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        pos = end + 1;
+        ++lineno;
+        ++row;
+        if (line.size() > width && errors.empty()) {
+            errors.emplace_back(Location(*source, lineno, width + 1) + "Width of template file is larger than "
+                "the limit " + std::to_string(width));
+        }
+        return true;
+    };
+
+    std::string_view line;
     for (int i = 0; i < header_lines; i++) {
-        std::getline(fin, line);
-        templte.lines.emplace_back(line);
-        max_width = std::max<int>(max_width, line.size());
+        next_line(line);
+        templte.pages.back().emplace_back(line);
     }
+    lineno = row = header_lines;
 
     Block curr_block {};
     curr_block.start_lineno = header_lines + 1;
-    int line_count = header_lines;
-    while (fin) {
-        std::getline(fin, line);
-        if (!fin) {
-            break;
+    while (next_line(line)) {
+        auto line_trimmed = Trim(line);
+        if (line_trimmed == "\f") { // a form feed starts a new page
+            templte.pages.emplace_back();
+            row = 0;
+            continue;
         }
-        ++line_count;
-        max_width = std::max<int>(max_width, line.size());
-        if (line_count > height) {
-            errors.emplace_back("Height of template file is larger than the limit " + std::to_string(height));
+        if (row > height) {
+            int page_no = templte.pages.size();
+            auto page = page_no > 1 ? "page " + std::to_string(page_no) + " of " : "";
+            errors.emplace_back(Location(*source, lineno, 1) + "Height of " + page + "template file is larger than "
+                "the limit " + std::to_string(height));
             break;
         }
-        templte.lines.emplace_back(line);
+        templte.pages.back().emplace_back(line);
 
-        auto line_trimmed = Trim(line);
         if (line_trimmed.length() > 0 && line_trimmed[0] == '=' && line_trimmed.back() == '=') {
             auto block_name = Trim(Trim(line_trimmed, '='), ' ');
-            if (block_name.size() > 0 && block_name.find_first_of(' ') == std::string::npos) {
-                if (line_count != curr_block.start_lineno) {
+            if (block_name.size() > 0 && block_name.find_first_of(' ') == std::string_view::npos) {
+                if (lineno != curr_block.start_lineno) {
                     templte.blocks.emplace_back(curr_block);
                 }
                 curr_block.name = block_name;
-                curr_block.start_lineno = line_count;
+                curr_block.start_lineno = lineno;
                 curr_block.wires.clear();
                 continue;
             }
         }
 
         int p = 0, q = 0;
-        std::string wire_name;
+        std::string_view wire_name;
         for (int i = 0; i < line.size(); i++) {
             if (line[i] == ' ') {
                 p = i + 1;
             } else if (line[i] == ':') {
                 wire_name = line.substr(p, i - p);
                 q = i + 1;
-                while (q < line.size() && line[q] != '0') {
-                    ++q;
+                // decimal and binary placeholders only follow spaces, other text is skipped up to hex ones
+                int r = q;
+                while (r < line.size() && line[r] == ' ') {
+                    ++r;
+                }
+                auto format = PlaceholderAt(line, r);
+                if (format == WireFormat::Hex) {
+                    while (q < line.size() && line[q] != '0') {
+                        ++q;
+                    }
+                } else {
+                    q = r;
                 }
-                i = q;
-                while (i < line.size() && line[i] == '0') {
+                const char digit = format == WireFormat::Hex ? '0' : format == WireFormat::Binary ? 'b' : '#';
+                i = format == WireFormat::Signed ? q + 1 : q;
+                while (i < line.size() && line[i] == digit) {
                     ++i;
                 }
-                
+
                 int len_hex = i - q;
                 if (len_hex == 0) {
                     break;
@@ -87,8 +155,10 @@ std::optional<Template> Template::From(std::ifstream &fin, int header_lines, int
 
                 Wire wire { wire_name };
                 wire.len_hex = len_hex;
-                wire.temp_start_pos = q + (line_count - 1) * width;
-                wire.temp_end_pos = i - 1 + (line_count - 1) * width;
+                wire.format = format;
+                wire.page = templte.pages.size() - 1;
+                wire.temp_start_pos = q + (row - 1) * width;
+                wire.temp_end_pos = i - 1 + (row - 1) * width;
                 curr_block.wires.emplace_back(wire);
 
                 p = i;
@@ -101,14 +171,56 @@ std::optional<Template> Template::From(std::ifstream &fin, int header_lines, int
         templte.blocks.emplace_back(curr_block);
     }
     
-    if (max_width > width) {
-        errors.emplace_back("Width of template file is larger than the limit " + std::to_string(width));
-    }
     if (!errors.empty()) {
         for (const auto &error : errors) {
-            std::cerr << error << std::endl;
+            err << error << std::endl;
         }
         return std::nullopt;
     }
     return templte;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<const TemplateCache::Entry> TemplateCache::Load(const std::string &path, int header_lines, int width,
+    int height) {
+    auto entry = std::make_shared<Entry>();
+    auto source = MappedFile::Open(path);
+    if (!source) {
+        return entry;
+    }
+    entry->opened = true;
+    entry->content_hash = HashBytes(source->View());
+
+    std::ostringstream err;
+    auto temp_opt = Template::From(source, header_lines, width, height, err);
+    if (temp_opt.has_value()) {
+        entry->templte = std::make_shared<const Template>(std::move(temp_opt.value()));
+    }
+    entry->errors = std::move(err).str();
+    return entry;
+}
+
+std::shared_ptr<const TemplateCache::Entry> TemplateCache::Get(const std::string &path, int header_lines, int width,
+    int height) {
+    auto key = path + '\0' + std::to_string(header_lines) + ',' + std::to_string(width) + ','
+        + std::to_string(height);
+
+    std::promise<std::shared_ptr<const Entry>> promise;
+    std::shared_future<std::shared_ptr<const Entry>> future;
+    bool owner = false;
+    {
+        std::lock_guard lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            future = promise.get_future().share();
+            entries.emplace(key, future);
+            owner = true;
+        } else {
+            future = it->second;
+        }
+    }
+    if (owner) {
+        // the first user loads it while others wait for the result
+        promise.set_value(Load(path, header_lines, width, height));
+    }
+    return future.get();
+}
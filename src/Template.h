@@ -1,21 +1,53 @@
 #pragma once
 
-#include <fstream>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 
+#include "MappedFile.h"
 #include "Wire.h"
 
+// names of blocks and wires, and lines, are all views into 'Template::source'.
+// A line with only a form feed ('\f') starts a new page, each page is a screen of its own.
+
 struct Block {
-    std::string name;
+    std::string_view name;
     std::vector<Wire> wires;
     int start_lineno;
 };
 
 struct Template {
     std::vector<Block> blocks;
-    std::vector<std::string> lines;
+    std::vector<std::vector<std::string_view>> pages; // lines of each page, without line breaks
+    std::shared_ptr<const MappedFile> source;
+
+    // parses the template in one pass over 'source', errors are reported with line and column numbers
+    static std::optional<Template> From(std::shared_ptr<const MappedFile> source, int header_lines, int width,
+        int height, std::ostream &err = std::cerr);
+};
+
+// Loads each template file once and shares the result between generators, it can be used from several threads.
+class TemplateCache {
+public:
+    struct Entry {
+        bool opened = false;
+        std::shared_ptr<const Template> templte; // null if the file can't be opened or parsed
+        uint64_t content_hash = 0;
+        std::string errors; // messages of parsing errors
+    };
+
+    static std::shared_ptr<const Entry> Load(const std::string &path, int header_lines, int width, int height);
+
+    std::shared_ptr<const Entry> Get(const std::string &path, int header_lines, int width, int height);
 
-    static std::optional<Template> From(std::ifstream &fin, int header_lines, int width, int height);
+private:
+    std::mutex mutex;
+    std::map<std::string, std::shared_future<std::shared_ptr<const Entry>>> entries;
 };
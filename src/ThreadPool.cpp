@@ -0,0 +1,100 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int num_threads) {
+    num_threads = std::max(num_threads, 1);
+    for (int i = 0; i < num_threads; i++) {
+        queues.emplace_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < num_threads; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+    }
+    task_cv.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    int index;
+    {
+        std::lock_guard lock(mutex);
+        index = next_queue;
+        next_queue = (next_queue + 1) % queues.size();
+        ++pending;
+    }
+    {
+        std::lock_guard lock(queues[index]->mutex);
+        queues[index]->tasks.emplace_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(mutex);
+        ++queued;
+    }
+    task_cv.notify_one();
+}
+
+void ThreadPool::Wait() {
+    std::unique_lock lock(mutex);
+    done_cv.wait(lock, [this]() { return pending == 0; });
+}
+
+bool ThreadPool::TryPop(int index, std::function<void()> &task) {
+    {
+        auto &queue = *queues[index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+    for (int i = 1; i < queues.size(); i++) {
+        auto &queue = *queues[(index + i) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(int index) {
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            task_cv.wait(lock, [this]() { return queued > 0 || stop; });
+            if (queued == 0 && stop) {
+                return;
+            }
+        }
+
+        std::function<void()> task;
+        if (!TryPop(index, task)) {
+            // another worker has taken it but not updated 'queued' yet
+            std::this_thread::yield();
+            continue;
+        }
+        {
+            std::lock_guard lock(mutex);
+            --queued;
+        }
+        task();
+        {
+            std::lock_guard lock(mutex);
+            if (--pending == 0) {
+                done_cv.notify_all();
+            }
+        }
+    }
+}
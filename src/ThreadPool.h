@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Each worker has its own task queue, it runs tasks from the back of it and steals tasks from the front
+// of other queues when it is empty.
+class ThreadPool {
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    void Submit(std::function<void()> task);
+    // waits until all submitted tasks are finished
+    void Wait();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(int index);
+    bool TryPop(int index, std::function<void()> &task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable task_cv;
+    std::condition_variable done_cv;
+    int queued = 0; // tasks in queues
+    int pending = 0; // tasks not finished
+    int next_queue = 0;
+    bool stop = false;
+};
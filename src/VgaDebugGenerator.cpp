@@ -1,299 +1,1813 @@
 #include "VgaDebugGenerator.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <iostream>
 #include <iomanip>
+#include <optional>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "Config.h"
+#include "Emitter.h"
+#include "File.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "SourceHash.h"
 #include "Template.h"
 #include "Wire.h"
 
-void VgaDebugGenerator::Run(const std::string &config_file) {
+namespace {
+
+// the 'index'-th part of 'width' bits of 'name'
+std::string Slice(const std::string &name, int index, int width) {
+    if (width == 1) {
+        return name + "[" + std::to_string(index) + "]";
+    }
+    return name + "[" + std::to_string(index * width + width - 1) + ":" + std::to_string(index * width) + "]";
+}
+
+// a binary constant of 'lanes' bits
+std::string LaneMask(unsigned mask, int lanes) {
+    std::string bits = std::to_string(lanes) + "'b";
+    for (int lane = lanes - 1; lane >= 0; lane--) {
+        bits += (mask >> lane & 1) ? '1' : '0';
+    }
+    return bits;
+}
+
+// fonts up to half of a block RAM are put in LUTs
+const int lutram_font_bits = 16384;
+// cycles from the position to the colour of the pipelined display, see 'Config::display_pipeline'
+const int display_latency = 3;
+
+// bits of an unsigned value up to 'max_value', at least 1
+int BitWidth(int max_value) {
+    int bits = 1;
+    while ((1LL << bits) <= max_value) {
+        ++bits;
+    }
+    return bits;
+}
+
+// log2 of 'value', which is a power of two
+int Log2(int value) {
+    int bits = 0;
+    while ((1 << bits) < value) {
+        ++bits;
+    }
+    return bits;
+}
+
+// bits shifted into the digits in each registered stage of 'Bin2Dec'
+const int dabble_step = 4;
+
+// decimal digits of the largest magnitude of 'bits' bits, which is 2^(bits-1) if it is signed
+int DecimalDigits(int bits, bool is_signed) {
+    return static_cast<int>((is_signed ? bits - 1 : bits) * std::log10(2.0)) + 1;
+}
+
+// characters of the value of 'wire' in the template if it has 'bits' bits
+int ValueChars(const Wire &wire, int bits) {
+    switch (wire.format) {
+    case WireFormat::Unsigned:
+        return DecimalDigits(bits, false);
+    case WireFormat::Signed:
+        return DecimalDigits(bits, true) + 1;
+    case WireFormat::Binary:
+        return bits;
+    default:
+        return (bits + 3) / 4;
+    }
+}
+
+}
+
+VgaDebugGenerator::VgaDebugGenerator(std::ostream &out, std::ostream &err, TemplateCache *template_cache)
+    : out_stream(&out), err_stream(&err), template_cache(template_cache) {}
+
+bool VgaDebugGenerator::Run(const std::string &config_file, bool force) {
+    stats = Stats {};
     try {
-        LoadConfig(config_file);
-        LoadTemplate();
-        ProcessConfig();
-        ProcessModules(config.module_name);
-        Generate();
+        RunPhase("LoadConfig", [&]() { LoadConfig(config_file); });
+        RunPhase("LoadTemplate", [&]() { LoadTemplate(); });
+        // the estimate needs the resolved wires, so outputs are regenerated (and kept if unchanged) for it
+        if (!force && report_format == StatsFormat::None && IsUpToDate()) {
+            *out_stream << "Outputs of '" << config_file << "' are up to date" << std::endl;
+            stats.Print(*out_stream, stats_format);
+            return true;
+        }
+        RunPhase("ProcessConfig", [&]() { ProcessConfig(); });
+        RunPhase("ProcessModules", [&]() { ProcessModules(config->module_name); });
+        RunPhase("Generate", [&]() {
+            Generate();
+            SaveCache();
+        });
     } catch (const std::string &error_msg) {
-        std::cerr << error_msg << std::endl;
+        *err_stream << error_msg << std::endl;
+        return false;
+    } catch (const std::exception &e) {
+        *err_stream << e.what() << std::endl;
+        return false;
+    }
+    stats.Print(*out_stream, stats_format);
+    estimate.Print(*out_stream, report_format);
+    return true;
+}
+
+GenerateResult VgaDebugGenerator::GenerateFrom(std::string_view config_content,
+    std::string_view template_content) {
+    stats = Stats {};
+    GenerateResult result;
+    // each line of the messages is an error
+    auto add_errors = [&](const std::string &phase, const std::string &messages) {
+        std::istringstream lines(messages);
+        std::string line;
+        while (std::getline(lines, line)) {
+            result.errors.emplace_back(GeneratorError { phase, line });
+        }
+    };
+
+    std::optional<Config> config_opt;
+    std::ostringstream err;
+    RunPhase("LoadConfig", [&]() {
+        std::istringstream config_fin { std::string(config_content) };
+        try {
+            config_opt = Config::From(config_fin, err);
+        } catch (const std::exception &e) {
+            err << e.what() << '\n';
+        }
+    });
+    if (!config_opt.has_value()) {
+        add_errors("LoadConfig", err.str());
+        return result;
     }
+
+    std::optional<Template> temp_opt;
+    RunPhase("LoadTemplate", [&]() {
+        temp_opt = Template::From(MappedFile::FromString(std::string(template_content), config_opt->template_file),
+            config_opt->header_lines, config_opt->template_width, config_opt->template_height, err);
+    });
+    if (!temp_opt.has_value()) {
+        add_errors("LoadTemplate", err.str());
+        return result;
+    }
+
+    auto load_phases = std::move(stats.phases);
+    result = GenerateFrom(std::make_shared<const Config>(std::move(config_opt.value())),
+        std::make_shared<const Template>(std::move(temp_opt.value())));
+    stats.phases.insert(stats.phases.begin(), load_phases.begin(), load_phases.end());
+    return result;
+}
+
+GenerateResult VgaDebugGenerator::GenerateFrom(std::shared_ptr<const Config> parsed_config,
+    std::shared_ptr<const Template> parsed_template) {
+    stats = Stats {};
+    GenerateResult result;
+    config = std::move(parsed_config);
+    templte = std::move(parsed_template);
+
+    captured_outputs = &result.artifacts;
+    std::string phase;
+    auto run_phase = [&](const std::string &name, const std::function<void()> &func) {
+        phase = name;
+        RunPhase(name, func);
+    };
+    try {
+        run_phase("ProcessConfig", [&]() { ProcessConfig(); });
+        run_phase("ProcessModules", [&]() { ProcessModules(config->module_name); });
+        run_phase("Generate", [&]() { Generate(); });
+    } catch (const std::string &error_msg) {
+        result.errors.emplace_back(GeneratorError { phase, error_msg });
+    } catch (const std::exception &e) {
+        result.errors.emplace_back(GeneratorError { phase, e.what() });
+    }
+    captured_outputs = nullptr;
+
+    result.ok = result.errors.empty();
+    if (!result.ok) {
+        result.artifacts.clear();
+    } else {
+        result.warnings = estimate.warnings;
+    }
+    return result;
+}
+
+void VgaDebugGenerator::RunPhase(const std::string &name, const std::function<void()> &func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    stats.phases.emplace_back(PhaseStats { name, ms, PeakRssKb() });
 }
 
 void VgaDebugGenerator::LoadConfig(const std::string &config_file) {
-    std::ifstream config_fin(config_file);
-    if (!config_fin) {
+    std::string content;
+    if (!ReadFile(config_file, content)) {
         throw "Failed to open config file '" + config_file + "'";
     }
-    auto config_opt = Config::From(config_fin);
+    config_hash = HashBytes(content);
+    std::istringstream config_fin(std::move(content));
+    auto config_opt = Config::From(config_fin, *err_stream);
     if (!config_opt.has_value()) {
         throw std::string("Failed to parse config file due to above reasons");
     }
-    config = config_opt.value();
+    config = std::make_shared<const Config>(std::move(config_opt.value()));
 }
 
 void VgaDebugGenerator::LoadTemplate() {
-    std::ifstream temp_fin(config.template_file);
-    if (!temp_fin) {
-        throw "Failed to open template file '" + config.template_file + "'";
+    auto entry = template_cache
+        ? template_cache->Get(config->template_file, config->header_lines, config->template_width,
+            config->template_height)
+        : TemplateCache::Load(config->template_file, config->header_lines, config->template_width,
+            config->template_height);
+    if (!entry->opened) {
+        throw "Failed to open template file '" + config->template_file + "'";
     }
-    auto temp_opt = Template::From(temp_fin, config.header_lines, config.template_width, config.template_height);
-    if (!temp_opt.has_value()) {
+    if (!entry->templte) {
+        *err_stream << entry->errors;
         throw std::string("Failed to parse template file due to above reasons");
     }
-    templte = temp_opt.value();
+    template_hash = entry->content_hash;
+    templte = entry->templte;
+    HashFont();
+}
+
+void VgaDebugGenerator::HashFont() {
+    // 'Generate_Font' reads the font, a missing one is reported there
+    font_hash = 0;
+    std::string font;
+    if (config->compact_font && ReadFile(config->font_file, font)) {
+        font_hash = HashBytes(font);
+    }
+}
+
+uint64_t VgaDebugGenerator::InputsHash() const {
+    // the sources of the generator rather than only its version, so that any change of them regenerates outputs
+    auto generator = HashBytes(VGA_DBG_GEN_VERSION " " VGA_DBG_GEN_SOURCE_HASH);
+    auto hash = HashValue(template_hash, HashValue(config_hash, generator));
+    return config->compact_font ? HashValue(font_hash, hash) : hash;
+}
+
+std::string VgaDebugGenerator::CacheFile() const {
+    return config->output_dir + config->dbg_header + ".hash";
+}
+
+bool VgaDebugGenerator::IsUpToDate() const {
+    std::ifstream fin(CacheFile());
+    uint64_t hash;
+    if (!(fin >> std::hex >> hash) || hash != InputsHash()) {
+        return false;
+    }
+    std::string file_name;
+    while (fin >> file_name) {
+        if (!std::filesystem::exists(config->output_dir + file_name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void VgaDebugGenerator::SaveCache() const {
+    auto inputs_hash = InputsHash();
+    Emitter out;
+    out.Hex(inputs_hash >> 32, 8);
+    out.Hex(inputs_hash & 0xffffffffu, 8);
+    out << '\n';
+    for (const auto &file_name : output_files) {
+        out << file_name << '\n';
+    }
+    if (!out.WriteTo(CacheFile())) {
+        *err_stream << "Failed to write cache file '" << CacheFile() << "'" << std::endl;
+    }
 }
 
 void VgaDebugGenerator::ProcessConfig() {
-    modules[config.module_name] = Module { config.module_name, "" };
-    for (const auto &[_, submodule] : config.submodule) {
-        if (submodule.parent_name == config.module_name || config.submodule.count(submodule.parent_name)) {
+    modules.clear();
+    resolved_attrs.clear();
+    wires.clear();
+    names = StringPool();
+
+    modules[config->module_name] = Module { config->module_name, "" };
+    for (const auto &[_, submodule] : config->submodule) {
+        if (submodule.parent_name == config->module_name || config->submodule.count(submodule.parent_name)) {
             modules[submodule.name] = Module { submodule.name, submodule.parent_name };
         } else {
             throw "Can't find parent module '" + submodule.parent_name + "' of module '" + submodule.name + "'";
         }
     }
-    for (const auto &[_, submodule] : config.submodule) {
+    for (const auto &[_, submodule] : config->submodule) {
         modules[submodule.parent_name].submodule_names.emplace_back(submodule.name);
     }
 
-    for (auto &block : templte.blocks) {
+    std::string full_name;
+    auto &top_module = modules[config->module_name];
+    for (const auto &block : templte->blocks) {
+        std::string block_name(block.name);
         std::string block_prefix = "";
-        if (config.block_prefix.count(block.name)) {
-            block_prefix = config.block_prefix[block.name];
+        if (config->block_prefix.count(block_name)) {
+            block_prefix = config->block_prefix.at(block_name);
         }
         std::string block_suffix = "";
-        if (config.block_suffix.count(block.name)) {
-            block_suffix = config.block_suffix[block.name];
+        if (config->block_suffix.count(block_name)) {
+            block_suffix = config->block_suffix.at(block_name);
         }
 
-        bool len_bits_block_flag = config.len_bits.count(block.name);
-        bool wire_prefix_block_flag = config.wire_prefix.count(block.name);
-        bool wire_suffix_block_flag = config.wire_suffix.count(block.name);
-
-        for (auto &wire : block.wires) {
-            if (len_bits_block_flag && config.len_bits[block.name].count(wire.name)) {
-                wire.len_bits = config.len_bits[block.name][wire.name];
-            } else {
+        for (const auto &temp_wire : block.wires) {
+            Wire wire = temp_wire;
+            // all overrides of the wire, including those of its groups
+            const auto *attrs = config->ResolveAttrs(block.name, wire.name, resolved_attrs);
+            if (attrs && attrs->len_bits >= 0) {
+                wire.len_bits = attrs->len_bits;
+            } else if (wire.format == WireFormat::Hex) {
                 wire.len_bits = wire.len_hex == 1 ? 1 : wire.len_hex * 4;
+            } else {
+                // the most bits which fit in the placeholder
+                wire.len_bits = 1;
+                while (ValueChars(wire, wire.len_bits + 1) <= wire.len_hex) {
+                    ++wire.len_bits;
+                }
             }
 
             // prefix
-            if (wire_prefix_block_flag && config.wire_prefix[block.name].count(wire.name)) {
-                wire.full_name = config.wire_prefix[block.name][wire.name] + wire.name;
+            if (attrs && attrs->prefix >= 0) {
+                full_name = config->strings[attrs->prefix];
             } else {
-                wire.full_name = block_prefix + wire.name;
+                full_name = block_prefix;
             }
+            full_name += wire.name;
             // suffix
-            if (wire_suffix_block_flag && config.wire_suffix[block.name].count(wire.name)) {
-                wire.full_name = wire.full_name + config.wire_suffix[block.name][wire.name];
+            if (attrs && attrs->suffix >= 0) {
+                full_name += config->strings[attrs->suffix];
             } else {
-                wire.full_name = wire.full_name + block_suffix;
+                full_name += block_suffix;
             }
+            wire.full_name = names[names.Intern(full_name)];
             // wire_name
-            if (config.wire_name[block.name].count(wire.name)) {
-                wire.code_name = config.wire_name[block.name][wire.name];
+            if (attrs && attrs->name >= 0) {
+                wire.code_name = names[names.Intern(config->strings[attrs->name])];
             } else {
                 wire.code_name = wire.full_name;
             }
 
-            wire.module_name = config.FindSubmoduleOfWire(block.name, wire.name);
-            modules[wire.module_name].wires.emplace_back(wire);
+            auto *module = &top_module;
+            if (attrs && attrs->submodule >= 0) {
+                module = &modules.find(config->strings[attrs->submodule])->second;
+            }
+            wire.module_name = names[names.Intern(module->name)];
             
-            if (wire.len_bits > wire.len_hex * 4 || wire.len_bits <= (wire.len_hex - 1) * 4) {
-                throw "Wire '" + wire.name + " (" + wire.code_name + ")' has " + std::to_string(wire.len_bits)
-                    + " bit(s), but there are(is) " + std::to_string(wire.len_hex) + " '0' in template";
+            if (wire.format == WireFormat::Hex
+                && (wire.len_bits > wire.len_hex * 4 || wire.len_bits <= (wire.len_hex - 1) * 4)) {
+                throw "Wire '" + std::string(wire.name) + " (" + std::string(wire.code_name) + ")' has "
+                    + std::to_string(wire.len_bits) + " bit(s), but there are(is) " + std::to_string(wire.len_hex)
+                    + " '0' in template";
+            }
+            if (wire.format != WireFormat::Hex
+                && (wire.len_bits < 1 || ValueChars(wire, wire.len_bits) != wire.len_hex)) {
+                throw "Wire '" + std::string(wire.name) + " (" + std::string(wire.code_name) + ")' has "
+                    + std::to_string(wire.len_bits) + " bit(s), which take(s) "
+                    + std::to_string(ValueChars(wire, std::max(wire.len_bits, 1))) + " character(s), but there "
+                    "are(is) " + std::to_string(wire.len_hex) + " in template";
             }
+
+            module->wire_ids.emplace_back(wires.size());
+            wires.emplace_back(wire);
         }
     }
 
-    vga_size = config.template_width * config.template_height;
+    stats.modules = modules.size();
+    stats.wires = wires.size();
+    stats.nibbles = 0;
+    code_bits = 4;
+    for (const auto &wire : wires) {
+        stats.nibbles += wire.len_hex;
+        if (wire.format == WireFormat::Signed) {
+            code_bits = 5;
+        }
+    }
+
+    // rows of the generated display are a power of two characters apart, so that the address of a character
+    // is the bits of its position on the screen
+    timing = VgaTiming {};
+    Config::ParseVgaMode(config->vga_mode.empty() ? "640x480" : config->vga_mode, timing);
+    generated_vga = Config::MergeTiming(timing, config->vga_timing) || !config->vga_mode.empty()
+        || config->compact_font || config->display_pipeline;
+    row_stride = config->template_width;
+    if (generated_vga) {
+        row_stride = 1;
+        while (row_stride < config->template_width) {
+            row_stride <<= 1;
+        }
+        if (config->template_width * config->font_width > timing.h_visible
+            || config->template_height * config->font_height > timing.v_visible) {
+            throw "Template of " + std::to_string(config->template_width) + "x"
+                + std::to_string(config->template_height) + " characters of " + std::to_string(config->font_width)
+                + "x" + std::to_string(config->font_height) + " pixels doesn't fit in the screen of "
+                + std::to_string(timing.h_visible) + "x" + std::to_string(timing.v_visible);
+        }
+    }
+    vga_size = row_stride * config->template_height;
     vga_size_pow2 = 1;
     vga_size_log2 = 0;
     while (vga_size_pow2 < vga_size) {
         vga_size_pow2 <<= 1;
         ++vga_size_log2;
     }
+    page_count = templte->pages.size();
+    page_bits = 0;
+    while ((1 << page_bits) < page_count) {
+        ++page_bits;
+    }
+    lane_bits = 0;
+    while ((1 << lane_bits) < config->lanes) {
+        ++lane_bits;
+    }
+    if (lane_bits > 0 && lane_bits >= vga_size_log2) {
+        throw "Field 'lanes' should be less than the size of the screen " + std::to_string(vga_size);
+    }
+    if (config->lanes > 1 && config->mem_word_bytes != 1 && config->mem_word_bytes != config->lanes) {
+        throw std::string("Field 'mem_word_bytes' should be 1 or the same as 'lanes'");
+    }
+    // VgaDisplay reads a hex image with $readmemh into words of 'lanes' characters, wider words would be truncated
+    if ((config->mem_format == MemFormat::Hex || config->mem_format == MemFormat::HexSparse)
+        && config->mem_word_bytes > config->lanes) {
+        throw std::string("Field 'mem_word_bytes' should be 1 or the same as 'lanes' if 'mem_format' is 'hex' or "
+            "'hex_sparse', since VgaDisplay reads the image with $readmemh");
+    }
+    CollectGlyphs();
 }
 
 void VgaDebugGenerator::ProcessModules(const std::string &name) {
-    auto &module = modules[name];
-    module.wires_all = module.wires;
+    std::vector<Wire> sorted_wires;
+    sorted_wires.reserve(wires.size());
+    ProcessModule(name, sorted_wires);
+    wires = std::move(sorted_wires);
+}
+
+void VgaDebugGenerator::ProcessModule(const std::string &name, std::vector<Wire> &sorted_wires) {
+    auto &module = modules.at(name);
+    module.wires_begin = sorted_wires.size();
+    for (auto id : module.wire_ids) {
+        sorted_wires.emplace_back(wires[id]);
+    }
+    module.wires_end = sorted_wires.size();
+    module.wire_ids = {};
 
     for (const auto &submodule_name : module.submodule_names) {
-        ProcessModules(submodule_name);
-        const auto &submodule = modules[submodule_name];
-        for (const auto &wire : submodule.wires_all) {
-            module.wires_all.emplace_back(wire);
-        }
+        ProcessModule(submodule_name, sorted_wires);
     }
+    module.wires_all_end = sorted_wires.size();
+}
+
+WireRange VgaDebugGenerator::Wires(const Module &module) const {
+    return WireRange { wires.data() + module.wires_begin, wires.data() + module.wires_end };
+}
+
+WireRange VgaDebugGenerator::WiresAll(const Module &module) const {
+    return WireRange { wires.data() + module.wires_begin, wires.data() + module.wires_all_end };
 }
 
 void VgaDebugGenerator::Generate() {
+    output_files.clear();
+    pipeline_fan_in = 0;
+
+    if (config->compact_font) {
+        Generate_Font();
+    }
     Generate_Mem();
     Generate_VgaDebugger();
+    if (generated_vga) {
+        Generate_VgaController();
+    }
     Generate_VgaDisplay();
 
-    std::ofstream fout(config.output_dir + config.dbg_header);
-    if (!fout) {
-        throw "Failed to open debug header file '" + config.dbg_header + "'";
+    size_t header_size = 0;
+    for (const auto &[_, module] : modules) {
+        header_size += 256 + (Wires(module).size() * 2 + WiresAll(module).size() * 3) * 64;
+    }
+    Emitter out(header_size);
+    out << "// generated by vga-debugger-generator (Pepcy Chen)";
+    Generate_VgaInstance(out);
+    Generate_Modules(out);
+    WriteOutput(out, config->dbg_header, "debug header file");
+
+    EstimateResources();
+}
+
+void VgaDebugGenerator::EstimateResources() {
+    estimate = Estimate {};
+    const auto wires_all = WiresAll(modules[config->module_name]);
+    const int lanes = config->lanes;
+    const int addr_bits = page_bits + vga_size_log2 - lane_bits;
+    const bool dynamic = config->scan_mode == ScanMode::Dynamic;
+    auto div_ceil = [](int a, int b) { return (a + b - 1) / b; };
+    // levels of a tree of 'fan_in'-input nodes reducing 'count' leaves
+    auto levels = [](int count, int fan_in) {
+        int levels = 0;
+        for (long long leaves = 1; leaves < count; leaves *= fan_in) {
+            ++levels;
+        }
+        return levels;
+    };
+
+    // memories, the font has 256 glyphs unless it is compact
+    estimate.char_ram_bits = (generated_vga ? RamCells() : (1 << addr_bits) * lanes) * 8;
+    const int font_glyphs = config->compact_font ? glyphs.size() : 256;
+    estimate.font_rom_bits = font_glyphs * (generated_vga ? config->font_height : 16) * 8;
+    // a small compact font is in LUTs instead of a block RAM
+    const int font_bram_bits = config->compact_font && estimate.font_rom_bits <= lutram_font_bits ? 0
+        : estimate.font_rom_bits;
+    estimate.bram_bits = estimate.char_ram_bits + font_bram_bits;
+    estimate.bram_blocks = div_ceil(estimate.char_ram_bits, 32768) + div_ceil(font_bram_bits, 32768);
+
+    // the scan
+    const auto arms = ScanArms(wires_all);
+    std::vector<int> page_arms(page_count, 0);
+    for (const auto &arm : arms) {
+        page_arms[arm.addr >> (vga_size_log2 - lane_bits)]++;
+    }
+    const int max_arms = *std::max_element(page_arms.begin(), page_arms.end());
+    const int index_bits = std::max(levels(max_arms, 2), 1);
+    const int counter_bits = dynamic ? index_bits : vga_size_log2 - lane_bits;
+    const int inputs = std::max<int>(arms.size(), 1);
+    const int data_bits = lanes * (code_bits + 1); // characters and write enables of the lanes
+    estimate.mux_inputs = arms.size();
+    estimate.mux_select_bits = page_bits + counter_bits;
+    estimate.mux_width = data_bits + (dynamic ? addr_bits : 0);
+    estimate.luts = counter_bits + lanes * 4; // the counter and 'Hex2Ascii', which is 8 functions of 4 inputs
+    estimate.ffs = counter_bits;
+    if (pipeline_fan_in == 0) {
+        // a LUT is a 4:1 mux
+        estimate.luts += estimate.mux_width * div_ceil(inputs - 1, 3);
+        estimate.logic_levels = std::max(levels(inputs, 4), 1) + 1;
+    } else {
+        // the compare of each arm, then AND-OR of 3 arms per LUT in the first stage and OR of 6 afterwards
+        const int compare_luts = div_ceil(estimate.mux_select_bits, 6);
+        const int first_levels = std::max(levels(estimate.mux_select_bits, 6), 1)
+            + std::max(levels(pipeline_fan_in, 3), 1);
+        estimate.luts += inputs * compare_luts;
+        if (dynamic) {
+            estimate.luts += addr_bits * div_ceil(inputs, 64); // the address ROM, a LUT holds 64 entries
+        }
+        estimate.logic_levels = std::max(first_levels, levels(pipeline_fan_in, 6));
+        int count = inputs;
+        for (int stage = 1; stage <= stats.pipeline_stages; stage++) {
+            int groups = div_ceil(count, pipeline_fan_in);
+            estimate.luts += groups * data_bits * div_ceil(std::min(count, pipeline_fan_in), stage == 1 ? 3 : 6);
+            estimate.ffs += groups * data_bits + addr_bits;
+            count = groups;
+        }
+    }
+    if (config->cdc_snapshot) {
+        int snap_bits = 0;
+        for (const auto &wire : wires_all) {
+            snap_bits += wire.len_bits;
+        }
+        estimate.ffs += snap_bits * 2 + 6;
+    }
+    // 'Bin2Dec' of decimal wires, a step adjusts each digit by a LUT level, 2 digits per LUT
+    auto converter_cycles = [&](const Wire &wire) {
+        if (wire.format != WireFormat::Unsigned && wire.format != WireFormat::Signed) {
+            return 0;
+        }
+        return div_ceil(wire.len_bits, dabble_step) + (wire.format == WireFormat::Signed ? 1 : 0);
+    };
+    for (const auto &wire : wires_all) {
+        if (converter_cycles(wire) == 0) {
+            continue;
+        }
+        const bool is_signed = wire.format == WireFormat::Signed;
+        const int digits = DecimalDigits(wire.len_bits, is_signed);
+        estimate.luts += wire.len_bits * div_ceil(digits, 2) + (is_signed ? wire.len_bits : 0);
+        estimate.ffs += div_ceil(wire.len_bits, dabble_step) * (digits * 4 + wire.len_bits + 1)
+            + (is_signed ? wire.len_bits + 1 : 0);
+        estimate.logic_levels = std::max(estimate.logic_levels, std::min(wire.len_bits, dabble_step));
+    }
+
+    // a wire waits at most a whole scan of its page, the pipeline, its converter, and a handshake of the
+    // snapshot, which is counted as 6 cycles as if both clocks are the same
+    const int extra_cycles = stats.pipeline_stages + (config->cdc_snapshot ? 6 : 0);
+    const WireEstimate *worst = nullptr;
+    for (const auto &wire : wires_all) {
+        int period = dynamic ? std::max(page_arms[wire.page], 1) : div_ceil(vga_size, lanes);
+        estimate.wires.emplace_back(WireEstimate { std::string(wire.full_name), wire.page,
+            period + extra_cycles + converter_cycles(wire) });
+    }
+    for (const auto &wire : estimate.wires) {
+        if (!worst || wire.refresh_cycles > worst->refresh_cycles) {
+            worst = &wire;
+        }
+    }
+    estimate.refresh_cycles = worst ? worst->refresh_cycles : 0;
+
+    // the port plumbing of each level of the hierarchy
+    std::function<void(const Module &, int)> walk = [&](const Module &module, int depth) {
+        int port_bits = 0;
+        for (const auto &wire : WiresAll(module)) {
+            port_bits += wire.len_bits;
+        }
+        estimate.modules.emplace_back(ModuleEstimate { module.name, depth, WiresAll(module).size(), port_bits });
+        for (const auto &submodule_name : module.submodule_names) {
+            walk(modules.at(submodule_name), depth + 1);
+        }
+    };
+    walk(modules.at(config->module_name), 0);
+
+    const auto &limits = config->limits;
+    auto check = [&](const std::string &what, int value, const char *name, int limit) {
+        if (limit >= 0 && value > limit) {
+            estimate.warnings.emplace_back("Estimated " + what + " " + std::to_string(value) + " exceeds limit '"
+                + name + "' " + std::to_string(limit));
+        }
+    };
+    check("block RAM bits", estimate.bram_bits, "bram_bits", limits.bram_bits);
+    check("LUTs", estimate.luts, "luts", limits.luts);
+    check("logic levels", estimate.logic_levels, "logic_levels", limits.logic_levels);
+    check("scan mux inputs", estimate.mux_inputs, "mux_inputs", limits.mux_inputs);
+    if (worst) {
+        check("refresh cycles of wire '" + worst->name + "'", worst->refresh_cycles, "refresh_cycles",
+            limits.refresh_cycles);
+    }
+    // without the template text in the RAM only the values are shown, $readmemb can't read raw bytes either
+    if (config->mem_format != MemFormat::Hex && config->mem_format != MemFormat::HexSparse) {
+        estimate.warnings.emplace_back("VgaDisplay can't load '" + config->mem_file + "', the character RAM "
+            "should be initialized with it by the vendor memory IP, otherwise the template text isn't shown");
+    }
+    if (!captured_outputs) {
+        for (const auto &warning : estimate.warnings) {
+            *err_stream << "Warning: " << warning << std::endl;
+        }
+    }
+}
+
+void VgaDebugGenerator::WriteOutput(Emitter &out, const std::string &file_name, const std::string &kind) {
+    output_files.emplace_back(file_name);
+    if (captured_outputs) {
+        stats.outputs.emplace_back(OutputStats { file_name, out.Size(), true, out.ElapsedMs() });
+        captured_outputs->emplace_back(Artifact { file_name, kind, out.TakeBuffer() });
+        return;
+    }
+
+    // keep the file (and its mtime) if the content is not changed, so that synthesis tools won't rebuild it
+    auto path = config->output_dir + file_name;
+    std::error_code ec;
+    std::string old_content;
+    bool changed = std::filesystem::file_size(path, ec) != out.Size() || ec || !ReadFile(path, old_content)
+        || old_content != out.Buffer();
+    if (changed && !out.WriteTo(path)) {
+        throw "Failed to open " + kind + " '" + file_name + "'";
+    }
+    double ms = out.ElapsedMs();
+    stats.outputs.emplace_back(OutputStats { file_name, out.Size(), changed, ms });
+    *out_stream << (changed ? "Generated '" : "Unchanged '") << file_name << "': " << out.Size() << " bytes, "
+        << std::fixed << std::setprecision(3) << ms << " ms" << std::endl;
+}
+
+int VgaDebugGenerator::CellOf(const Wire &wire) const {
+    int row = wire.temp_start_pos / config->template_width;
+    int col = wire.temp_start_pos % config->template_width;
+    return wire.page * vga_size_pow2 + row * row_stride + col;
+}
+
+int VgaDebugGenerator::RamCells() const {
+    if (!generated_vga) {
+        return vga_size_pow2 * page_count;
+    }
+    // the generated display doesn't read past the last row, and a word holds the characters of all lanes
+    const int word_bytes = std::max(config->mem_word_bytes, config->lanes);
+    int cells = (page_count - 1) * vga_size_pow2 + vga_size;
+    return (cells + word_bytes - 1) / word_bytes * word_bytes;
+}
+
+std::vector<unsigned char> VgaDebugGenerator::MemImage() const {
+    std::vector<unsigned char> image(RamCells(), 0);
+    for (int page = 0; page < page_count; page++) {
+        auto page_begin = image.begin() + static_cast<size_t>(page) * vga_size_pow2;
+        int row = 0;
+        for (const auto &line : templte->pages[page]) {
+            int size = std::min<int>(line.size(), config->template_width);
+            std::copy(line.begin(), line.begin() + size, page_begin + row * row_stride);
+            ++row;
+        }
     }
+    return image;
+}
 
-    fout << "// generated by vga-debugger-generator (Pepcy Chen)";
-    Generate_VgaInstance(fout);
-    Generate_Modules(fout);
+FrameRenderer VgaDebugGenerator::MakeRenderer(std::vector<unsigned char> font) const {
+    std::vector<RenderWire> render_wires;
+    for (const auto &wire : WiresAll(modules.at(config->module_name))) {
+        render_wires.emplace_back(RenderWire { std::string(wire.full_name), wire.len_hex, wire.len_bits,
+            CellOf(wire), wire.format });
+    }
+    // 'vga/VgaDisplay.v' only supports 8x16 glyphs
+    RenderLayout layout { config->template_width, config->template_height, row_stride, vga_size_pow2, page_count,
+        generated_vga ? config->font_width : 8, generated_vga ? config->font_height : 16 };
+    return FrameRenderer(MemImage(), layout, std::move(render_wires), std::move(font));
+}
+
+bool VgaDebugGenerator::RenderTrace(const std::string &trace_file, const std::string &font_file,
+    FrameFormat format) {
+    auto font = FrameRenderer::LoadFont(font_file);
+    if (!font.has_value()) {
+        *err_stream << "Failed to open font file '" << font_file << "'" << std::endl;
+        return false;
+    }
+    std::ifstream fin(trace_file);
+    if (!fin) {
+        *err_stream << "Failed to open trace file '" << trace_file << "'" << std::endl;
+        return false;
+    }
+    auto dir = config->output_dir + "frames/";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        *err_stream << "Failed to create directory '" << dir << "': " << ec.message() << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto renderer = MakeRenderer(std::move(font.value()));
+    const char *extension = format == FrameFormat::Txt ? ".txt" : format == FrameFormat::Ppm ? ".ppm" : ".png";
+    std::string line, error;
+    int lineno = 0;
+    int frames = 0;
+    while (std::getline(fin, line)) {
+        ++lineno;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (!renderer.Apply(line, error)) {
+            *err_stream << trace_file << ":" << lineno << ": " << error << std::endl;
+            return false;
+        }
+        std::ostringstream name;
+        name << dir << "frame_" << std::setw(5) << std::setfill('0') << frames++ << extension;
+        std::ofstream fout(name.str(), std::ios::binary);
+        if (!fout) {
+            *err_stream << "Failed to open frame '" << name.str() << "'" << std::endl;
+            return false;
+        }
+        renderer.Write(fout, format);
+        fout.close();
+        if (!fout) {
+            *err_stream << "Failed to write frame '" << name.str() << "'" << std::endl;
+            return false;
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    *out_stream << "Rendered " << frames << " frame(s) to '" << dir << "': " << std::fixed << std::setprecision(3)
+        << ms << " ms" << std::endl;
+    return true;
+}
+
+void VgaDebugGenerator::CollectGlyphs() {
+    std::array<bool, 256> shown {};
+    shown[0] = true; // cells after the end of a line
+    for (const auto &page : templte->pages) {
+        for (const auto &line : page) {
+            int size = std::min<int>(line.size(), config->template_width);
+            for (int i = 0; i < size; i++) {
+                shown[static_cast<unsigned char>(line[i])] = true;
+            }
+        }
+    }
+    for (const auto &wire : wires) {
+        const char *chars = wire.format == WireFormat::Hex ? "0123456789abcdef"
+            : wire.format == WireFormat::Signed ? "0123456789 -"
+            : wire.format == WireFormat::Binary ? "01" : "0123456789";
+        for (const char *ch = chars; *ch != '\0'; ch++) {
+            shown[static_cast<unsigned char>(*ch)] = true;
+        }
+    }
+
+    glyphs.clear();
+    for (int ch = 0; ch < 256; ch++) {
+        if (!config->compact_font) {
+            glyph_of[ch] = ch;
+        } else if (shown[ch]) {
+            glyph_of[ch] = glyphs.size();
+            glyphs.emplace_back(ch);
+        } else {
+            glyph_of[ch] = -1;
+        }
+    }
+    glyph_bits = config->compact_font ? BitWidth(glyphs.size() - 1) : 8;
+}
+
+std::string VgaDebugGenerator::FontMemName() const {
+    if (config->compact_font) {
+        return std::filesystem::path(config->mem_file).stem().string() + "_font.mem";
+    }
+    return std::filesystem::path(config->font_file).filename().string();
+}
+
+void VgaDebugGenerator::Generate_Font() {
+    auto font = FrameRenderer::LoadFont(config->font_file);
+    if (!font.has_value()) {
+        throw "Failed to open font file '" + config->font_file + "'";
+    }
+    Emitter out(glyphs.size() * config->font_height * 3);
+    for (auto ch : glyphs) {
+        for (int row = 0; row < config->font_height; row++) {
+            size_t index = static_cast<size_t>(ch) * config->font_height + row;
+            out.Hex(index < font->size() ? (*font)[index] : 0, 2);
+            out << '\n';
+        }
+    }
+    WriteOutput(out, FontMemName(), "font file");
 }
 
 void VgaDebugGenerator::Generate_Mem() {
-    std::ofstream fout(config.output_dir + config.mem_file);
-    if (!fout) {
-        throw "Failed to open memory file '" + config.mem_file + "'";
+    auto image = MemImage();
+    if (config->compact_font) {
+        for (auto &ch : image) {
+            ch = glyph_of[ch];
+        }
     }
+    // a word of the RAM holds the characters of all lanes
+    const int word_bytes = std::max(config->mem_word_bytes, config->lanes);
+    if (image.size() % word_bytes != 0) {
+        throw "Field 'mem_word_bytes' is larger than the size of the character RAM "
+            + std::to_string(image.size());
+    }
+    const int depth = image.size() / word_bytes;
+    const int word_width = word_bytes * 2; // in hex digits
+    int addr_width = 1; // in hex digits
+    while ((1LL << (addr_width * 4)) < depth) {
+        ++addr_width;
+    }
+    // the lowest address at the lowest bits
+    auto word = [&](int index) {
+        uint64_t value = 0;
+        for (int i = word_bytes - 1; i >= 0; i--) {
+            value = (value << 8) | image[index * word_bytes + i];
+        }
+        return value;
+    };
 
-    int curr = 0;
-    for (const auto &line : templte.lines) {
-        for (int i = 0; i < config.template_width; i++) {
-            if (i < line.size()) {
-                fout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(line[i]) << std::endl;
-            } else {
-                fout << "00" << std::endl;
+    Emitter out(config->mem_format == MemFormat::Bin ? image.size() : depth * (word_width + 8) + 256);
+    switch (config->mem_format) {
+    case MemFormat::Hex:
+        for (int i = 0; i < depth; i++) {
+            out.Hex(word(i), word_width);
+            out << '\n';
+        }
+        break;
+    case MemFormat::HexSparse: {
+        // a run of zeros is skipped if '@address' is shorter than writing it out
+        const int min_run = (addr_width + 2) / (word_width + 1) + 1;
+        int i = 0;
+        while (i < depth) {
+            int run_end = i;
+            while (run_end < depth && word(run_end) == 0) {
+                ++run_end;
+            }
+            if (run_end == depth) {
+                break; // uninitialized words of the BRAM are zero
+            }
+            if (run_end - i >= min_run) {
+                out << '@';
+                out.Hex(run_end, addr_width);
+                out << '\n';
+                i = run_end;
+            }
+            for (; i <= run_end; i++) {
+                out.Hex(word(i), word_width);
+                out << '\n';
             }
-            ++curr;
         }
+        break;
     }
-    while (curr < vga_size_pow2) {
-        fout << "00" << std::endl;
-        ++curr;
+    case MemFormat::Coe:
+        out << "memory_initialization_radix=16;\n";
+        out << "memory_initialization_vector=\n";
+        for (int i = 0; i < depth; i++) {
+            out.Hex(word(i), word_width);
+            out << (i + 1 < depth ? ",\n" : ";\n");
+        }
+        break;
+    case MemFormat::Mif:
+        out << "WIDTH=" << word_bytes * 8 << ";\n";
+        out << "DEPTH=" << depth << ";\n\n";
+        out << "ADDRESS_RADIX=HEX;\n";
+        out << "DATA_RADIX=HEX;\n\n";
+        out << "CONTENT BEGIN\n";
+        for (int i = 0; i < depth;) {
+            // runs of the same word are written as ranges
+            int run_end = i + 1;
+            while (run_end < depth && word(run_end) == word(i)) {
+                ++run_end;
+            }
+            out << "    ";
+            if (run_end - i > 1) {
+                out << '[';
+                out.Hex(i, addr_width);
+                out << "..";
+                out.Hex(run_end - 1, addr_width);
+                out << ']';
+            } else {
+                out.Hex(i, addr_width);
+            }
+            out << " : ";
+            out.Hex(word(i), word_width);
+            out << ";\n";
+            i = run_end;
+        }
+        out << "END;\n";
+        break;
+    case MemFormat::Bin:
+        for (auto byte : image) {
+            out << static_cast<char>(byte);
+        }
+        break;
     }
+
+    WriteOutput(out, config->mem_file, "memory file");
 }
+
 void VgaDebugGenerator::Generate_VgaDebugger() {
-    std::ofstream fout(config.output_dir + "VgaDebugger.v");
-    if (!fout) {
-        throw "Failed to open memory file 'VgaDebugger.v'";
-    }
-
-    fout << "// generated by vga-debugger-generator (Pepcy Chen)\n" << std::endl;
-    fout << "module Hex2Ascii(" << std::endl;
-    fout << "    input wire [3:0] hex," << std::endl;
-    fout << "    output reg [7:0] ascii" << std::endl;
-    fout << ");\n" << std::endl;
-    fout << "    always @* begin" << std::endl;
-    fout << "        case (hex)" << std::endl;
-    fout << "            4'h0: ascii = 48;" << std::endl;
-    fout << "            4'h1: ascii = 49;" << std::endl;
-    fout << "            4'h2: ascii = 50;" << std::endl;
-    fout << "            4'h3: ascii = 51;" << std::endl;
-    fout << "            4'h4: ascii = 52;" << std::endl;
-    fout << "            4'h5: ascii = 53;" << std::endl;
-    fout << "            4'h6: ascii = 54;" << std::endl;
-    fout << "            4'h7: ascii = 55;" << std::endl;
-    fout << "            4'h8: ascii = 56;" << std::endl;
-    fout << "            4'h9: ascii = 57;" << std::endl;
-    fout << "            4'ha: ascii = 97;" << std::endl;
-    fout << "            4'hb: ascii = 98;" << std::endl;
-    fout << "            4'hc: ascii = 99;" << std::endl;
-    fout << "            4'hd: ascii = 100;" << std::endl;
-    fout << "            4'he: ascii = 101;" << std::endl;
-    fout << "            4'hf: ascii = 102;" << std::endl;
-    fout << "        endcase" << std::endl;
-    fout << "    end\n" << std::endl;
-    fout << "endmodule\n" << std::endl;
-
-    fout << "module VgaDebugger(" << std::endl;
-    for (const auto &wire : modules[config.module_name].wires_all) {
+    const auto wires_all = WiresAll(modules[config->module_name]);
+    int nibbles = 0;
+    for (const auto &wire : wires_all) {
+        nibbles += wire.len_hex;
+    }
+    Emitter out(2048 + wires_all.size() * 64 + nibbles * 80);
+
+    out << "// generated by vga-debugger-generator (Pepcy Chen)\n" << '\n';
+    if (config->compact_font) {
+        out << "// 'ascii' is the index of the character in the compact font" << '\n';
+    }
+    out << "module Hex2Ascii(" << '\n';
+    out << "    input wire [" << code_bits - 1 << ":0] hex," << '\n';
+    out << "    output reg [7:0] ascii" << '\n';
+    out << ");\n" << '\n';
+    out << "    always @* begin" << '\n';
+    out << "        case (hex)" << '\n';
+    const char *digits = "0123456789abcdef";
+    for (int code = 0; code < 16; code++) {
+        // digits no wire has are left out of a compact font
+        if (glyph_of[digits[code]] >= 0) {
+            out << "            4'h" << digits[code] << ": ascii = " << glyph_of[digits[code]] << ";" << '\n';
+        }
+    }
+    if (code_bits > 4) {
+        // signs of signed decimal wires
+        out << "            5'h10: ascii = " << glyph_of[' '] << ";" << '\n';
+        out << "            5'h11: ascii = " << glyph_of['-'] << ";" << '\n';
+        out << "            default: ascii = " << glyph_of[' '] << ";" << '\n';
+    } else if (config->compact_font) {
+        out << "            default: ascii = 0;" << '\n';
+    }
+    out << "        endcase" << '\n';
+    out << "    end\n" << '\n';
+    out << "endmodule\n" << '\n';
+
+    bool decimal = false;
+    for (const auto &wire : wires_all) {
+        decimal = decimal || wire.format == WireFormat::Unsigned || wire.format == WireFormat::Signed;
+    }
+    if (decimal) {
+        Generate_Bin2Dec(out);
+    }
+
+    out << "module VgaDebugger(" << '\n';
+    for (const auto &wire : wires_all) {
         if (wire.len_bits == 1) {
-            fout << "    input wire " << wire.full_name << "," << std::endl;
+            out << "    input wire " << wire.full_name << "," << '\n';
         } else {
-            fout << "    input wire [" << wire.len_bits - 1 << ":0] " << wire.full_name << "," << std::endl;
+            out << "    input wire [" << wire.len_bits - 1 << ":0] " << wire.full_name << "," << '\n';
         }
     }
-    fout << "    input wire clk," << std::endl;
-    fout << "    output reg display_wen," << std::endl;
-    fout << "    output wire [" << vga_size_log2 - 1 <<  ":0] display_w_addr," << std::endl;
-    fout << "    output wire [7:0] display_w_data" << std::endl;
-    fout << ");\n" << std::endl;
+    if (config->cdc_snapshot) {
+        out << "    input wire src_clk," << '\n';
+    }
+    out << "    input wire clk," << '\n';
+    if (page_bits > 0) {
+        out << "    input wire [" << page_bits - 1 << ":0] page," << '\n';
+    }
+    const int addr_bits = page_bits + vga_size_log2 - lane_bits;
+    if (config->lanes == 1) {
+        out << "    output reg display_wen," << '\n';
+        out << "    output wire [" << addr_bits - 1 <<  ":0] display_w_addr," << '\n';
+        out << "    output wire [7:0] display_w_data" << '\n';
+    } else {
+        // a word of 'lanes' characters is written at a time, 'display_wen' has a bit for each of them
+        out << "    output reg [" << config->lanes - 1 << ":0] display_wen," << '\n';
+        out << "    output wire [" << addr_bits - 1 <<  ":0] display_w_addr," << '\n';
+        out << "    output wire [" << config->lanes * 8 - 1 << ":0] display_w_data" << '\n';
+    }
+    out << ");\n" << '\n';
 
-    fout << "    reg [" << vga_size_log2 - 1 << ":0] display_addr = 0;" << std::endl;
-    fout << "    assign display_w_addr = display_addr;" << std::endl;
-    fout << "    always @(posedge clk) begin" << std::endl;
-    fout << "        display_addr <= display_addr == " << vga_size - 1 << " ? 0 : display_addr + 1;" << std::endl;
-    fout << "    end\n" << std::endl;
+    if (config->cdc_snapshot) {
+        Generate_Snapshot(wires_all, out);
+    }
+    if (decimal) {
+        Generate_DecimalWires(wires_all, out);
+    }
+    if (config->scan_mode == ScanMode::Dynamic) {
+        Generate_DynamicScan(wires_all, out);
+    } else {
+        Generate_FullScan(wires_all, out);
+    }
 
-    fout << "    reg [3:0] dynamic_hex = 0;" << std::endl;
-    fout << "    Hex2Ascii hex2ascii(dynamic_hex, display_w_data);" << std::endl;
-    fout << "    always @* begin" << std::endl;
-    fout << "        case (display_addr)" << std::endl;
+    out << "endmodule" << '\n';
+
+    WriteOutput(out, "VgaDebugger.v", "Verilog file");
+}
 
-    for (const auto &wire : modules[config.module_name].wires_all) {
+std::vector<VgaDebugGenerator::ScanArm> VgaDebugGenerator::ScanArms(WireRange wires_all) const {
+    std::vector<ScanArm> arms;
+    std::unordered_map<int, int> arm_ids; // keyed by the word address
+    for (const auto &wire : wires_all) {
+        const int first_cell = CellOf(wire);
         for (int i = 0; i < wire.len_hex; i++) {
-            fout << "            " << wire.temp_start_pos + i << ": begin ";
-            int lb = std::min(wire.len_bits, (wire.len_hex - i) * 4) - 1;
-            int rb = std::min(wire.len_bits, (wire.len_hex - i - 1) * 4);
-            if (lb == 0)  {
-                fout << "dynamic_hex = " << wire.full_name << "; ";
-            } else if (lb < rb) {
-                fout << "dynamic_hex = 0; ";
+            int cell = first_cell + i;
+            int addr = cell >> lane_bits;
+            auto [it, inserted] = arm_ids.emplace(addr, arms.size());
+            if (inserted) {
+                arms.emplace_back(ScanArm { addr, addr, std::vector<ScanNibble>(config->lanes) });
+            }
+            arms[it->second].lanes[cell & (config->lanes - 1)] = ScanNibble { &wire, i };
+        }
+    }
+    return arms;
+}
+
+void VgaDebugGenerator::Generate_Snapshot(WireRange wires_all, Emitter &out) {
+    int snap_bits = 0;
+    for (const auto &wire : wires_all) {
+        snap_bits += wire.len_bits;
+    }
+    snap_bits = std::max(snap_bits, 1);
+
+    // 'snap_src' is only loaded when the handshake is idle, so it is stable while 'snap' samples it
+    out << "    // all wires are sampled at once on 'src_clk' and handed to 'clk' by a req/ack toggle handshake,"
+        << '\n';
+    out << "    // 'snap_src' to 'snap' is held for the handshake and can be constrained as a false path" << '\n';
+    out << "    reg [" << snap_bits - 1 << ":0] snap_src = 0;" << '\n';
+    out << "    reg snap_req = 0;" << '\n';
+    out << "    reg snap_ack = 0;" << '\n';
+    out << "    (* ASYNC_REG = \"TRUE\" *) reg [1:0] snap_ack_sync = 0;" << '\n';
+    out << "    always @(posedge src_clk) begin" << '\n';
+    out << "        snap_ack_sync <= { snap_ack_sync[0], snap_ack };" << '\n';
+    out << "        if (snap_req == snap_ack_sync[1]) begin" << '\n';
+    out << "            snap_src <= {";
+    bool first = true;
+    for (const auto &wire : wires_all) {
+        out << (first ? " " : ", ") << wire.full_name;
+        first = false;
+    }
+    out << (first ? " 1'b0 };" : " };") << '\n';
+    out << "            snap_req <= ~snap_req;" << '\n';
+    out << "        end" << '\n';
+    out << "    end\n" << '\n';
+
+    out << "    reg [" << snap_bits - 1 << ":0] snap = 0;" << '\n';
+    out << "    (* ASYNC_REG = \"TRUE\" *) reg [1:0] snap_req_sync = 0;" << '\n';
+    out << "    always @(posedge clk) begin" << '\n';
+    out << "        snap_req_sync <= { snap_req_sync[0], snap_req };" << '\n';
+    out << "        if (snap_req_sync[1] != snap_ack) begin" << '\n';
+    out << "            snap <= snap_src;" << '\n';
+    out << "            snap_ack <= snap_req_sync[1];" << '\n';
+    out << "        end" << '\n';
+    out << "    end" << '\n';
+
+    // the first wire is at the highest bits
+    int lb = snap_bits;
+    for (const auto &wire : wires_all) {
+        int rb = lb - wire.len_bits;
+        if (wire.len_bits == 1) {
+            out << "    wire snap_" << wire.full_name << " = snap[" << rb << "];" << '\n';
+        } else {
+            out << "    wire [" << wire.len_bits - 1 << ":0] snap_" << wire.full_name << " = snap[" << lb - 1
+                << ":" << rb << "];" << '\n';
+        }
+        lb = rb;
+    }
+    out << '\n';
+}
+
+void VgaDebugGenerator::Generate_Bin2Dec(Emitter &out) {
+    out << "// converts 'bin' to BCD digits by double dabble, 'STEP' bits are shifted in each registered stage, so"
+        << '\n';
+    out << "// the digits lag 'bin' by 'WIDTH / STEP' cycles (rounded up), and one more if it is 'SIGNED'" << '\n';
+    out << "module Bin2Dec #(" << '\n';
+    out << "    parameter WIDTH = 8," << '\n';
+    out << "    parameter DIGITS = 3," << '\n';
+    out << "    parameter SIGNED = 0," << '\n';
+    out << "    parameter STEP = " << dabble_step << '\n';
+    out << ") (" << '\n';
+    out << "    input wire clk," << '\n';
+    out << "    input wire [WIDTH-1:0] bin," << '\n';
+    out << "    output wire [DIGITS*4-1:0] bcd," << '\n';
+    out << "    output wire neg" << '\n';
+    out << ");\n" << '\n';
+    out << "    localparam STAGES = (WIDTH + STEP - 1) / STEP;" << '\n';
+    out << "    localparam BCD = DIGITS * 4;\n" << '\n';
+    out << "    // the magnitude is registered before the stages, so that the negation is a path of its own"
+        << '\n';
+    out << "    wire [WIDTH-1:0] mag;" << '\n';
+    out << "    wire mag_neg;" << '\n';
+    out << "    generate" << '\n';
+    out << "        if (SIGNED) begin : negate" << '\n';
+    out << "            reg [WIDTH-1:0] mag_r = 0;" << '\n';
+    out << "            reg neg_r = 0;" << '\n';
+    out << "            always @(posedge clk) begin" << '\n';
+    out << "                mag_r <= bin[WIDTH-1] ? -bin : bin;" << '\n';
+    out << "                neg_r <= bin[WIDTH-1];" << '\n';
+    out << "            end" << '\n';
+    out << "            assign mag = mag_r;" << '\n';
+    out << "            assign mag_neg = neg_r;" << '\n';
+    out << "        end else begin : unsigned_mag" << '\n';
+    out << "            assign mag = bin;" << '\n';
+    out << "            assign mag_neg = 0;" << '\n';
+    out << "        end" << '\n';
+    out << "    endgenerate\n" << '\n';
+    out << "    // digits, bits not shifted in yet (from the highest one) and the sign after each stage" << '\n';
+    out << "    wire [BCD*(STAGES+1)-1:0] digits;" << '\n';
+    out << "    wire [WIDTH*(STAGES+1)-1:0] rest;" << '\n';
+    out << "    wire [STAGES:0] signs;" << '\n';
+    out << "    assign digits[BCD-1:0] = 0;" << '\n';
+    out << "    assign rest[WIDTH-1:0] = mag;" << '\n';
+    out << "    assign signs[0] = mag_neg;\n" << '\n';
+    out << "    genvar s;" << '\n';
+    out << "    generate" << '\n';
+    out << "        for (s = 0; s < STAGES; s = s + 1) begin : stage" << '\n';
+    out << "            reg [BCD-1:0] digits_r = 0;" << '\n';
+    out << "            reg [WIDTH-1:0] rest_r = 0;" << '\n';
+    out << "            reg sign_r = 0;" << '\n';
+    out << "            reg [BCD-1:0] d;" << '\n';
+    out << "            reg [WIDTH-1:0] r;" << '\n';
+    out << "            integer i, k;" << '\n';
+    out << "            always @(posedge clk) begin" << '\n';
+    out << "                d = digits[s*BCD +: BCD];" << '\n';
+    out << "                r = rest[s*WIDTH +: WIDTH];" << '\n';
+    out << "                for (i = 0; i < STEP; i = i + 1) begin" << '\n';
+    out << "                    if (s * STEP + i < WIDTH) begin" << '\n';
+    out << "                        // digits of 5 or more are adjusted, so that they carry when doubled" << '\n';
+    out << "                        for (k = 0; k < DIGITS; k = k + 1) begin" << '\n';
+    out << "                            if (d[k*4 +: 4] >= 5) begin" << '\n';
+    out << "                                d[k*4 +: 4] = d[k*4 +: 4] + 3;" << '\n';
+    out << "                            end" << '\n';
+    out << "                        end" << '\n';
+    out << "                        d = { d[BCD-2:0], r[WIDTH-1] };" << '\n';
+    out << "                        r = r << 1;" << '\n';
+    out << "                    end" << '\n';
+    out << "                end" << '\n';
+    out << "                digits_r <= d;" << '\n';
+    out << "                rest_r <= r;" << '\n';
+    out << "                sign_r <= signs[s];" << '\n';
+    out << "            end" << '\n';
+    out << "            assign digits[(s+1)*BCD +: BCD] = digits_r;" << '\n';
+    out << "            assign rest[(s+1)*WIDTH +: WIDTH] = rest_r;" << '\n';
+    out << "            assign signs[s+1] = sign_r;" << '\n';
+    out << "        end" << '\n';
+    out << "    endgenerate\n" << '\n';
+    out << "    assign bcd = digits[STAGES*BCD +: BCD];" << '\n';
+    out << "    assign neg = signs[STAGES];\n" << '\n';
+    out << "endmodule\n" << '\n';
+}
+
+void VgaDebugGenerator::Generate_DecimalWires(WireRange wires_all, Emitter &out) {
+    // the sampled copy if wires cross to the VGA clock
+    const char *prefix = config->cdc_snapshot ? "snap_" : "";
+    for (const auto &wire : wires_all) {
+        if (wire.format != WireFormat::Unsigned && wire.format != WireFormat::Signed) {
+            continue;
+        }
+        const bool is_signed = wire.format == WireFormat::Signed;
+        const int digits = DecimalDigits(wire.len_bits, is_signed);
+        out << "    wire [" << digits * 4 - 1 << ":0] dec_" << wire.full_name << ";" << '\n';
+        if (is_signed) {
+            out << "    wire neg_" << wire.full_name << ";" << '\n';
+        }
+        out << "    Bin2Dec #(.WIDTH(" << wire.len_bits << "), .DIGITS(" << digits << "), .SIGNED("
+            << (is_signed ? 1 : 0) << ")) bin2dec_" << wire.full_name << "(" << '\n';
+        out << "        .clk(clk), .bin(" << prefix << wire.full_name << "), .bcd(dec_" << wire.full_name
+            << "), .neg(";
+        if (is_signed) {
+            out << "neg_" << wire.full_name;
+        }
+        out << "));" << '\n';
+    }
+    out << '\n';
+}
+
+void VgaDebugGenerator::Generate_FullScan(WireRange wires_all, Emitter &out) {
+    const int addr_bits = vga_size_log2 - lane_bits;
+    const int words = (vga_size + config->lanes - 1) / config->lanes;
+    // only the selected page is scanned, the page is the high bits of the address
+    out << "    reg [" << addr_bits - 1 << ":0] display_addr = 0;" << '\n';
+    std::string key = "display_addr";
+    if (page_bits > 0) {
+        out << "    wire [" << page_bits + addr_bits - 1 << ":0] page_addr = { page, display_addr };" << '\n';
+        key = "page_addr";
+    }
+    if (config->pipeline_stages == 0) {
+        out << "    assign display_w_addr = " << key << ";" << '\n';
+    }
+    out << "    always @(posedge clk) begin" << '\n';
+    out << "        display_addr <= display_addr == " << words - 1 << " ? 0 : display_addr + 1;" << '\n';
+    out << "    end\n" << '\n';
+
+    const auto arms = ScanArms(wires_all);
+    if (config->pipeline_stages > 0) {
+        Generate_PipelinedScan(arms, key, page_bits + addr_bits, false, out);
+        return;
+    }
+
+    out << "    reg [" << config->lanes * code_bits - 1 << ":0] dynamic_hex = 0;" << '\n';
+    Generate_Hex2Ascii("dynamic_hex", out);
+    out << "    always @* begin" << '\n';
+    out << "        case (" << key << ")" << '\n';
+    for (const auto &arm : arms) {
+        out << "            " << arm.key << ": begin ";
+        Generate_ArmWrite(arm, out);
+        out << "end" << '\n';
+        ++stats.case_arms;
+    }
+    out << "            default: begin dynamic_hex = 0; display_wen = 0; end" << '\n';
+    out << "        endcase" << '\n';
+    out << "    end\n" << '\n';
+}
+
+void VgaDebugGenerator::Generate_DynamicScan(WireRange wires_all, Emitter &out) {
+    const int addr_bits = page_bits + vga_size_log2 - lane_bits;
+    auto arms = ScanArms(wires_all);
+    // words with nibbles of each page, in the order they are scanned
+    std::vector<int> page_arms(page_count, 0);
+    for (const auto &arm : arms) {
+        page_arms[arm.addr >> (vga_size_log2 - lane_bits)]++;
+    }
+    int max_arms = *std::max_element(page_arms.begin(), page_arms.end());
+    int index_bits = 1;
+    while ((1 << index_bits) < max_arms) {
+        ++index_bits;
+    }
+    std::vector<int> next_index(page_count, 0);
+    for (auto &arm : arms) {
+        int page = arm.addr >> (vga_size_log2 - lane_bits);
+        arm.key = (page << index_bits) + next_index[page]++;
+    }
+
+    // only cells of nibbles are visited, an index into them is mapped to the address by a ROM
+    out << "    reg [" << index_bits - 1 << ":0] nibble_index = 0;" << '\n';
+    if (page_bits > 0) {
+        out << "    reg [" << index_bits - 1 << ":0] last_index;" << '\n';
+        out << "    always @* begin" << '\n';
+        out << "        case (page)" << '\n';
+        for (int page = 0; page < page_count; page++) {
+            int last_index = std::max(page_arms[page] - 1, 0);
+            out << "            " << page << ": last_index = " << last_index << ";" << '\n';
+        }
+        out << "            default: last_index = 0;" << '\n';
+        out << "        endcase" << '\n';
+        out << "    end" << '\n';
+        out << "    always @(posedge clk) begin" << '\n';
+        out << "        nibble_index <= nibble_index >= last_index ? 0 : nibble_index + 1;" << '\n';
+        out << "    end\n" << '\n';
+    } else {
+        out << "    always @(posedge clk) begin" << '\n';
+        int last_index = std::max(max_arms - 1, 0);
+        out << "        nibble_index <= nibble_index == " << last_index << " ? 0 : nibble_index + 1;" << '\n';
+        out << "    end\n" << '\n';
+    }
+
+    std::string key = page_bits > 0 ? "{ page, nibble_index }" : "nibble_index";
+    if (config->pipeline_stages > 0) {
+        Generate_PipelinedScan(arms, key, page_bits + index_bits, true, out);
+        return;
+    }
+
+    out << "    reg [" << addr_bits - 1 << ":0] display_addr;" << '\n';
+    out << "    assign display_w_addr = display_addr;" << '\n';
+    out << "    reg [" << config->lanes * code_bits - 1 << ":0] dynamic_hex;" << '\n';
+    Generate_Hex2Ascii("dynamic_hex", out);
+    out << "    always @* begin" << '\n';
+    out << "        case (" << key << ")" << '\n';
+    for (const auto &arm : arms) {
+        out << "            " << arm.key << ": begin display_addr = " << arm.addr << "; ";
+        Generate_ArmWrite(arm, out);
+        out << "end" << '\n';
+        ++stats.case_arms;
+    }
+    out << "            default: begin display_addr = 0; dynamic_hex = 0; display_wen = 0; end" << '\n';
+    out << "        endcase" << '\n';
+    out << "    end\n" << '\n';
+}
+
+void VgaDebugGenerator::Generate_PipelinedScan(const std::vector<ScanArm> &arms, const std::string &key,
+    int key_bits, bool addr_rom, Emitter &out) {
+    const int addr_bits = page_bits + vga_size_log2 - lane_bits;
+    const int lanes = config->lanes;
+    const int arm_count = std::max<int>(arms.size(), 1);
+    // the smallest fan-in which reduces all arms to one in the given stages, there are fewer stages if
+    // the fan-in would be less than 2
+    int fan_in = 2;
+    auto stages_of = [&](int fan_in) {
+        int stages = 0;
+        for (int count = arm_count; count > 1; count = (count + fan_in - 1) / fan_in) {
+            ++stages;
+        }
+        return std::max(stages, 1);
+    };
+    while (stages_of(fan_in) > config->pipeline_stages) {
+        ++fan_in;
+    }
+    const int stages = stages_of(fan_in);
+    stats.pipeline_stages = stages;
+    pipeline_fan_in = fan_in;
+
+    out << "    // a one-hot AND-OR tree of " << stages << " registered stage(s) with a fan-in of " << fan_in
+        << ", writes lag the scan by " << stages << " cycle(s)" << '\n';
+    out << "    wire [" << key_bits - 1 << ":0] scan_key = " << key << ";" << '\n';
+    if (addr_rom) {
+        out << "    reg [" << addr_bits - 1 << ":0] scan_addr;" << '\n';
+        out << "    always @* begin" << '\n';
+        out << "        case (scan_key)" << '\n';
+        for (const auto &arm : arms) {
+            out << "            " << arm.key << ": scan_addr = " << arm.addr << ";" << '\n';
+        }
+        out << "            default: scan_addr = 0;" << '\n';
+        out << "        endcase" << '\n';
+        out << "    end" << '\n';
+    } else {
+        out << "    wire [" << addr_bits - 1 << ":0] scan_addr = scan_key;" << '\n';
+    }
+
+    out << "    wire [" << arm_count - 1 << ":0] arm_hit;" << '\n';
+    out << "    wire [" << arm_count * lanes * code_bits - 1 << ":0] arm_hex;" << '\n';
+    if (arms.empty()) {
+        out << "    assign arm_hit = 0;" << '\n';
+        out << "    assign arm_hex = 0;" << '\n';
+    }
+    std::vector<unsigned> arm_masks(arm_count, (1u << lanes) - 1);
+    for (int k = 0; k < arms.size(); k++) {
+        out << "    assign arm_hit[" << k << "] = scan_key == " << arms[k].key << ";" << '\n';
+        arm_masks[k] = 0;
+        for (int lane = 0; lane < lanes; lane++) {
+            const auto &nibble = arms[k].lanes[lane];
+            out << "    assign " << Slice("arm_hex", k * lanes + lane, code_bits) << " = ";
+            if (nibble.wire) {
+                Generate_Nibble(*nibble.wire, nibble.index, out);
+                arm_masks[k] |= 1u << lane;
             } else {
-                fout << "dynamic_hex = " << wire.full_name << "[" << lb << ":" << rb << "]; ";
+                out << "0";
             }
-            fout << "display_wen = 1; end" << std::endl;
+            out << ";" << '\n';
+        }
+        ++stats.case_arms;
+    }
+    out << '\n';
+
+    // '_hit' of each group has a bit for each lane, lanes without nibbles are never written
+    std::string prev = "arm";
+    int prev_count = arm_count;
+    for (int stage = 1; stage <= stages; stage++) {
+        const int count = (prev_count + fan_in - 1) / fan_in;
+        const std::string curr = "stage" + std::to_string(stage);
+        out << "    reg [" << count * lanes - 1 << ":0] " << curr << "_hit = 0;" << '\n';
+        out << "    reg [" << count * lanes * code_bits - 1 << ":0] " << curr << "_hex = 0;" << '\n';
+        out << "    reg [" << addr_bits - 1 << ":0] " << curr << "_addr = 0;" << '\n';
+        out << "    always @(posedge clk) begin" << '\n';
+        out << "        " << curr << "_addr <= " << (stage == 1 ? "scan" : prev) << "_addr;" << '\n';
+        for (int g = 0; g < count; g++) {
+            int first = g * fan_in;
+            int last = std::min(first + fan_in, prev_count);
+            out << "        " << Slice(curr + "_hit", g, lanes) << " <= ";
+            for (int c = first; c < last; c++) {
+                out << (c > first ? " | " : "");
+                if (stage > 1) {
+                    out << Slice(prev + "_hit", c, lanes);
+                } else if (lanes == 1) {
+                    out << "arm_hit[" << c << "]";
+                } else if (arm_masks[c] == (1u << lanes) - 1) {
+                    out << "{" << lanes << "{arm_hit[" << c << "]}}";
+                } else {
+                    out << "({" << lanes << "{arm_hit[" << c << "]}} & " << LaneMask(arm_masks[c], lanes) << ")";
+                }
+            }
+            out << ";" << '\n';
+            // values of arms which are not hit are masked in the first stage, so they are zero afterwards
+            out << "        " << Slice(curr + "_hex", g, lanes * code_bits) << " <= ";
+            for (int c = first; c < last; c++) {
+                out << (c > first ? " | " : "");
+                if (stage == 1) {
+                    out << "(" << Slice("arm_hex", c, lanes * code_bits) << " & {" << lanes * code_bits
+                        << "{arm_hit[" << c << "]}})";
+                } else {
+                    out << Slice(prev + "_hex", c, lanes * code_bits);
+                }
+            }
+            out << ";" << '\n';
+        }
+        out << "    end\n" << '\n';
+        prev = curr;
+        prev_count = count;
+    }
+
+    out << "    assign display_w_addr = " << prev << "_addr;" << '\n';
+    out << "    always @* begin" << '\n';
+    out << "        display_wen = " << Slice(prev + "_hit", 0, lanes) << ";" << '\n';
+    out << "    end" << '\n';
+    Generate_Hex2Ascii(prev + "_hex", out);
+    out << '\n';
+
+    if (!captured_outputs) {
+        *out_stream << "VgaDebugger is pipelined in " << stages << " stage(s)" << std::endl;
+    }
+}
+
+void VgaDebugGenerator::Generate_ArmWrite(const ScanArm &arm, Emitter &out) {
+    if (config->lanes == 1) {
+        out << "dynamic_hex = ";
+        Generate_Nibble(*arm.lanes[0].wire, arm.lanes[0].index, out);
+        out << "; display_wen = 1; ";
+        return;
+    }
+    // every lane is assigned, so that no latch is inferred
+    unsigned mask = 0;
+    for (int lane = 0; lane < config->lanes; lane++) {
+        const auto &nibble = arm.lanes[lane];
+        out << Slice("dynamic_hex", lane, code_bits) << " = ";
+        if (nibble.wire) {
+            Generate_Nibble(*nibble.wire, nibble.index, out);
+            mask |= 1u << lane;
+        } else {
+            out << "0";
+        }
+        out << "; ";
+    }
+    out << "display_wen = " << LaneMask(mask, config->lanes) << "; ";
+}
+
+void VgaDebugGenerator::Generate_Hex2Ascii(const std::string &hex, Emitter &out) {
+    if (config->lanes == 1) {
+        out << "    Hex2Ascii hex2ascii(" << hex << ", display_w_data);" << '\n';
+        return;
+    }
+    for (int lane = 0; lane < config->lanes; lane++) {
+        out << "    Hex2Ascii hex2ascii_" << lane << "(" << Slice(hex, lane, code_bits) << ", "
+            << Slice("display_w_data", lane, 8) << ");" << '\n';
+    }
+}
+
+void VgaDebugGenerator::Generate_Nibble(const Wire &wire, int i, Emitter &out) {
+    // the sampled copy if wires cross to the VGA clock
+    const char *prefix = config->cdc_snapshot ? "snap_" : "";
+    if (wire.format == WireFormat::Binary) {
+        if (wire.len_bits == 1) {
+            out << prefix << wire.full_name;
+        } else {
+            out << prefix << wire.full_name << "[" << wire.len_hex - 1 - i << "]";
         }
+        return;
+    }
+    if (wire.format == WireFormat::Signed && i == 0) {
+        // ' ' or '-' in 'Hex2Ascii'
+        out << "{ 4'b1000, neg_" << wire.full_name << " }";
+        return;
+    }
+    if (wire.format != WireFormat::Hex) {
+        // digits of the converter, which are already registered
+        int digit = wire.len_hex - 1 - i;
+        out << "dec_" << wire.full_name << "[" << digit * 4 + 3 << ":" << digit * 4 << "]";
+        return;
+    }
+    int lb = std::min(wire.len_bits, (wire.len_hex - i) * 4) - 1;
+    int rb = std::min(wire.len_bits, (wire.len_hex - i - 1) * 4);
+    if (lb == 0)  {
+        out << prefix << wire.full_name;
+    } else if (lb < rb) {
+        out << "0";
+    } else {
+        out << prefix << wire.full_name << "[" << lb << ":" << rb << "]";
     }
+}
+
+void VgaDebugGenerator::Generate_VgaController() {
+    const auto &t = timing;
+    const int h_total = t.h_visible + t.h_front_porch + t.h_sync + t.h_back_porch;
+    const int v_total = t.v_visible + t.v_front_porch + t.v_sync + t.v_back_porch;
+    const int h_bits = BitWidth(h_total - 1);
+    const int v_bits = BitWidth(v_total - 1);
+    const int x_bits = BitWidth(t.h_visible - 1);
+    const int y_bits = BitWidth(t.v_visible - 1);
+    const char *hs_on = t.h_sync_positive ? "1" : "0";
+    const char *hs_off = t.h_sync_positive ? "0" : "1";
+    const char *vs_on = t.v_sync_positive ? "1" : "0";
+    const char *vs_off = t.v_sync_positive ? "0" : "1";
+    Emitter out(4096);
+
+    out << "// generated by vga-debugger-generator (Pepcy Chen)\n" << '\n';
+    std::ostringstream clock_mhz;
+    clock_mhz << std::fixed << std::setprecision(3) << h_total * v_total * 60.0 / 1e6;
+    out << "// " << t.h_visible << "x" << t.v_visible << " in " << h_total << "x" << v_total
+        << " pixels, 'clk' is the pixel clock, which is " << clock_mhz.str() << " MHz for 60 Hz" << '\n';
+    out << "module VgaController(" << '\n';
+    out << "    input wire clk," << '\n';
+    out << "    input wire rst," << '\n';
+    out << "    output reg [" << x_bits - 1 << ":0] vga_x," << '\n';
+    out << "    output reg [" << y_bits - 1 << ":0] vga_y," << '\n';
+    out << "    output reg hs," << '\n';
+    out << "    output reg vs," << '\n';
+    out << "    output reg video_on" << '\n';
+    out << ");\n" << '\n';
 
-    fout << "            default: begin dynamic_hex = 0; display_wen = 0; end" << std::endl;
-    fout << "        endcase" << std::endl;
-    fout << "    end\n" << std::endl;
+    // no subtraction is needed for the position if the counters start at the visible area
+    out << "    // each line (and frame) is the visible area, the front porch, the sync pulse and the back porch"
+        << '\n';
+    out << "    reg [" << h_bits - 1 << ":0] h_count = 0;" << '\n';
+    out << "    reg [" << v_bits - 1 << ":0] v_count = 0;" << '\n';
+    out << "    always @(posedge clk) begin" << '\n';
+    out << "        if (rst) begin" << '\n';
+    out << "            h_count <= 0;" << '\n';
+    out << "            v_count <= 0;" << '\n';
+    out << "        end else if (h_count == " << h_total - 1 << ") begin" << '\n';
+    out << "            h_count <= 0;" << '\n';
+    out << "            v_count <= v_count == " << v_total - 1 << " ? 0 : v_count + 1;" << '\n';
+    out << "        end else begin" << '\n';
+    out << "            h_count <= h_count + 1;" << '\n';
+    out << "        end" << '\n';
+    out << "    end\n" << '\n';
 
-    fout << "endmodule" << std::endl;
+    out << "    // all outputs are registered, so that they are aligned" << '\n';
+    out << "    always @(posedge clk) begin" << '\n';
+    out << "        vga_x <= h_count;" << '\n';
+    out << "        vga_y <= v_count;" << '\n';
+    out << "        video_on <= h_count < " << t.h_visible << " && v_count < " << t.v_visible << ";" << '\n';
+    out << "        hs <= h_count >= " << t.h_visible + t.h_front_porch << " && h_count < "
+        << t.h_visible + t.h_front_porch + t.h_sync << " ? " << hs_on << " : " << hs_off << ";" << '\n';
+    out << "        vs <= v_count >= " << t.v_visible + t.v_front_porch << " && v_count < "
+        << t.v_visible + t.v_front_porch + t.v_sync << " ? " << vs_on << " : " << vs_off << ";" << '\n';
+    out << "    end\n" << '\n';
+    out << "endmodule" << '\n';
+
+    WriteOutput(out, "VgaController.v", "Verilog file");
 }
+
 void VgaDebugGenerator::Generate_VgaDisplay() {
+    // 'vga/VgaDisplay.v' is used for single page templates written a character at a time
+    if (!generated_vga && page_count == 1 && config->lanes == 1) {
+        return;
+    }
+    const int addr_bits = page_bits + vga_size_log2 - lane_bits;
+    const int word_bits = config->lanes * 8;
+    const int x_bits = generated_vga ? BitWidth(timing.h_visible - 1) : 10;
+    const int y_bits = generated_vga ? BitWidth(timing.v_visible - 1) : 9;
+    const int depth = generated_vga ? RamCells() / config->lanes : 1 << addr_bits;
+    Emitter out(4096);
+
+    out << "// generated by vga-debugger-generator (Pepcy Chen)\n" << '\n';
+    out << "module VgaDisplay(" << '\n';
+    out << "    input wire clk," << '\n';
+    out << "    input wire video_on," << '\n';
+    out << "    input wire [" << x_bits - 1 << ":0] vga_x," << '\n';
+    out << "    input wire [" << y_bits - 1 << ":0] vga_y," << '\n';
+    if (config->display_pipeline) {
+        out << "    input wire hs," << '\n';
+        out << "    input wire vs," << '\n';
+    }
+    if (page_bits > 0) {
+        out << "    input wire [" << page_bits - 1 << ":0] page," << '\n';
+    }
+    out << "    output wire [3:0] vga_r," << '\n';
+    out << "    output wire [3:0] vga_g," << '\n';
+    out << "    output wire [3:0] vga_b," << '\n';
+    if (config->display_pipeline) {
+        // the syncs delayed as the colour
+        out << "    output wire vga_hs," << '\n';
+        out << "    output wire vga_vs," << '\n';
+    }
+    if (config->lanes == 1) {
+        out << "    input wire wen," << '\n';
+    } else {
+        out << "    input wire [" << config->lanes - 1 << ":0] wen," << '\n';
+    }
+    out << "    input wire [" << addr_bits - 1 << ":0] w_addr," << '\n';
+    out << "    input wire [" << word_bits - 1 << ":0] w_data" << '\n';
+    out << ");\n" << '\n';
 
+    // one screen of characters per page, 'lanes' characters per word with the first one at the lowest bits
+    out << "    (* ram_style = \"block\" *) reg [" << word_bits - 1 << ":0] display_data[0:" << depth - 1 << "];"
+        << '\n';
+    if (config->mem_format == MemFormat::Hex || config->mem_format == MemFormat::HexSparse) {
+        out << "    initial $readmemh(\"" << config->mem_file << "\", display_data);" << '\n';
+    } else {
+        // see the warning in 'EstimateResources'
+        out << "    // '" << config->mem_file << "' can't be read by $readmemh, initialize this RAM through the "
+            "vendor memory IP" << '\n';
+    }
+    out << '\n';
+    if (generated_vga) {
+        Generate_TextPixel(out);
+    } else {
+        // rows are 'template_width' characters apart, as in the .mem file and the addresses VgaDebugger writes
+        out << "    wire [" << vga_size_log2 - 1 << ":0] text_index = (vga_y / 16) * " << config->template_width
+            << " + vga_x / 8;" << '\n';
+        // 'text_index' of pixels right of or below the template is another character or out of the page
+        out << "    wire text_on = vga_x < " << config->template_width * 8 << " && vga_y < "
+            << config->template_height * 16 << ";" << '\n';
+        std::string text_addr = page_bits > 0 ? "{ page, text_index }" : "text_index";
+        if (config->lanes == 1) {
+            out << "    wire [7:0] text_ascii = display_data[" << text_addr << "];" << '\n';
+        } else {
+            std::string word_index = "text_index[" + std::to_string(vga_size_log2 - 1) + ":"
+                + std::to_string(lane_bits) + "]";
+            text_addr = page_bits > 0 ? "{ page, " + word_index + " }" : word_index;
+            out << "    wire [" << word_bits - 1 << ":0] text_word = display_data[" << text_addr << "];" << '\n';
+            out << "    wire [7:0] text_ascii = text_word[text_index[" << lane_bits - 1 << ":0] * 8 +: 8];"
+                << '\n';
+        }
+        out << "    wire [2:0] font_x = vga_x % 8;" << '\n';
+        out << "    wire [3:0] font_y = vga_y % 16;" << '\n';
+        out << "    wire [11:0] font_addr = text_ascii * 16 + font_y;\n" << '\n';
+        out << "    (* ram_style = \"block\" *) reg [7:0] fonts_data[0:4095];" << '\n';
+        out << "    initial $readmemh(\"font_8x16.mem\", fonts_data);" << '\n';
+        out << "    wire [7:0] font_data = fonts_data[font_addr];\n" << '\n';
+        out << "    assign { vga_r, vga_g, vga_b } = (video_on & text_on & font_data[7 - font_x]) ? 12'hfff : "
+            "12'h0;\n" << '\n';
+    }
+    out << "    always @(posedge clk) begin" << '\n';
+    if (config->lanes == 1) {
+        out << "        if (wen) begin" << '\n';
+        out << "            display_data[w_addr] <= w_data;" << '\n';
+        out << "        end" << '\n';
+    } else {
+        // byte enables, which block RAMs support natively
+        for (int lane = 0; lane < config->lanes; lane++) {
+            out << "        if (wen[" << lane << "]) begin" << '\n';
+            out << "            " << Slice("display_data[w_addr]", lane, 8) << " <= " << Slice("w_data", lane, 8)
+                << ";" << '\n';
+            out << "        end" << '\n';
+        }
+    }
+    out << "    end\n" << '\n';
+    out << "endmodule" << '\n';
+
+    WriteOutput(out, "VgaDisplay.v", "Verilog file");
 }
-void VgaDebugGenerator::Generate_VgaInstance(std::ofstream &fout) {
-    fout << "\n\n`define VGA_DBG_VgaDebugger_Arguments";
-    for (const auto &wire : modules[config.module_name].wires_all) {
-        fout << " \\\n    ." << wire.full_name << "(dbg_" << wire.full_name << "),";
+
+void VgaDebugGenerator::Generate_TextPixel(Emitter &out) {
+    const int font_x_bits = Log2(config->font_width);
+    const int font_y_bits = Log2(config->font_height);
+    const int col_bits = Log2(row_stride);
+    const int row_bits = vga_size_log2 - col_bits;
+
+    out << "    // " << config->template_width << "x" << config->template_height << " characters of "
+        << config->font_width << "x" << config->font_height << " pixels, rows are " << row_stride
+        << " characters apart in the RAM" << '\n';
+    out << "    // so that the address of a character is the high bits of its position" << '\n';
+    std::string row = "vga_y[" + std::to_string(font_y_bits + row_bits - 1) + ":" + std::to_string(font_y_bits)
+        + "]";
+    std::string col = "vga_x[" + std::to_string(font_x_bits + col_bits - 1) + ":" + std::to_string(font_x_bits)
+        + "]";
+    std::string text_index = row_bits == 0 ? col : col_bits == 0 ? row : "{ " + row + ", " + col + " }";
+    out << "    wire [" << vga_size_log2 - 1 << ":0] text_index = " << text_index << ";" << '\n';
+    // rows after the template may be out of the RAM
+    out << "    wire text_on = vga_x < " << config->template_width * config->font_width << " && vga_y < "
+        << config->template_height * config->font_height << ";" << '\n';
+    std::string word_index = "text_index";
+    if (config->lanes > 1) {
+        word_index += "[" + std::to_string(vga_size_log2 - 1) + ":" + std::to_string(lane_bits) + "]";
+    }
+    const std::string text_addr = page_bits > 0 ? "{ page, " + word_index + " }" : word_index;
+    const std::string lane = "text_index[" + std::to_string(lane_bits - 1) + ":0]";
+    // a character of a compact font is the index of its glyph
+    const std::string text_char = config->compact_font ? "text_glyph" : "text_ascii";
+    const std::string glyph = config->compact_font ? text_char + "[" + std::to_string(glyph_bits - 1) + ":0]"
+        : text_char;
+    // a row of a glyph is a byte with the leftmost pixel at the highest bit
+    const int font_bytes = (config->compact_font ? glyphs.size() : 256) * config->font_height;
+    const bool lutram = config->compact_font && font_bytes * 8 <= lutram_font_bits;
+    auto font_rom = [&] {
+        out << "    (* ram_style = \"" << (lutram ? "distributed" : "block") << "\" *) reg [7:0] fonts_data[0:"
+            << font_bytes - 1 << "];" << '\n';
+        out << "    initial $readmemh(\"" << FontMemName() << "\", fonts_data);" << '\n';
+    };
+
+    if (config->display_pipeline) {
+        std::string x_range = "[" + std::to_string(font_x_bits - 1) + ":0]";
+        std::string y_range = "[" + std::to_string(font_y_bits - 1) + ":0]";
+        out << '\n';
+        font_rom();
+        out << '\n';
+        out << "    // both memories are read into registers and the colour is registered too" << '\n';
+        out << "    // so the position, 'text_on' and the syncs are delayed by " << display_latency << " cycles"
+            << '\n';
+        if (config->lanes == 1) {
+            out << "    reg [7:0] " << text_char << ";" << '\n';
+        } else {
+            out << "    reg [" << config->lanes * 8 - 1 << ":0] text_word;" << '\n';
+            out << "    reg [" << lane_bits - 1 << ":0] text_lane;" << '\n';
+            out << "    wire [7:0] " << text_char << " = text_word[text_lane * 8 +: 8];" << '\n';
+        }
+        out << "    reg " << y_range << " font_y;" << '\n';
+        out << "    reg " << x_range << " font_x_1, font_x_2;" << '\n';
+        out << "    reg text_on_1, text_on_2;" << '\n';
+        out << "    reg [7:0] font_data;" << '\n';
+        out << "    reg [11:0] color;" << '\n';
+        out << "    reg [" << display_latency - 1 << ":0] hs_delay, vs_delay;" << '\n';
+        out << "    always @(posedge clk) begin" << '\n';
+        if (config->lanes == 1) {
+            out << "        " << text_char << " <= display_data[" << text_addr << "];" << '\n';
+        } else {
+            out << "        text_word <= display_data[" << text_addr << "];" << '\n';
+            out << "        text_lane <= " << lane << ";" << '\n';
+        }
+        out << "        font_y <= vga_y" << y_range << ";" << '\n';
+        out << "        font_x_1 <= vga_x" << x_range << ";" << '\n';
+        out << "        text_on_1 <= video_on & text_on;\n" << '\n';
+        out << "        font_data <= fonts_data[{ " << glyph << ", font_y }];" << '\n';
+        out << "        font_x_2 <= font_x_1;" << '\n';
+        out << "        text_on_2 <= text_on_1;\n" << '\n';
+        out << "        color <= (text_on_2 & font_data[7 - font_x_2]) ? 12'hfff : 12'h0;" << '\n';
+        out << "        hs_delay <= { hs_delay[" << display_latency - 2 << ":0], hs };" << '\n';
+        out << "        vs_delay <= { vs_delay[" << display_latency - 2 << ":0], vs };" << '\n';
+        out << "    end\n" << '\n';
+        out << "    assign { vga_r, vga_g, vga_b } = color;" << '\n';
+        out << "    assign vga_hs = hs_delay[" << display_latency - 1 << "];" << '\n';
+        out << "    assign vga_vs = vs_delay[" << display_latency - 1 << "];\n" << '\n';
+        return;
+    }
+
+    if (config->lanes == 1) {
+        out << "    wire [7:0] " << text_char << " = display_data[" << text_addr << "];" << '\n';
+    } else {
+        out << "    wire [" << config->lanes * 8 - 1 << ":0] text_word = display_data[" << text_addr << "];"
+            << '\n';
+        out << "    wire [7:0] " << text_char << " = text_word[" << lane << " * 8 +: 8];" << '\n';
+    }
+    out << '\n';
+
+    font_rom();
+    out << "    wire [7:0] font_data = fonts_data[{ " << glyph << ", vga_y[" << font_y_bits - 1 << ":0] }];\n"
+        << '\n';
+    out << "    assign { vga_r, vga_g, vga_b } = (video_on & text_on & font_data[7 - vga_x[" << font_x_bits - 1
+        << ":0]]) ? 12'hfff : 12'h0;\n" << '\n';
+}
+
+void VgaDebugGenerator::Generate_VgaInstance(Emitter &out) {
+    stats.macro_lines += 1 + WiresAll(modules[config->module_name]).size() + config->cdc_snapshot
+        + (page_bits > 0);
+    out << "\n\n`define VGA_DBG_VgaDebugger_Arguments";
+    for (const auto &wire : WiresAll(modules[config->module_name])) {
+        out << " \\\n    ." << wire.full_name << "(dbg_" << wire.full_name << "),";
+    }
+    // inputs of options are connected to wires named the same way, which the user drives
+    if (config->cdc_snapshot) {
+        out << " \\\n    .src_clk(dbg_src_clk),";
+    }
+    if (page_bits > 0) {
+        out << " \\\n    .page(dbg_page),";
     }
 }
 
-void VgaDebugGenerator::Generate_Modules(std::ofstream &fout) {
+void VgaDebugGenerator::Generate_Modules(Emitter &out) {
     for (const auto &[_, module] : modules) {
-        Generate_Outputs(module, fout);
-        Generate_Assignments(module, fout);
-        Generate_Declaration(module, fout);
-        Generate_Arguments(module, fout);
+        Generate_Outputs(module, out);
+        Generate_Assignments(module, out);
+        Generate_Declaration(module, out);
+        Generate_Arguments(module, out);
     }
 }
-void VgaDebugGenerator::Generate_Outputs(const Module &module, std::ofstream &fout) {
-    fout << "\n\n`define VGA_DBG_" << module.name << "_Outputs";
-    for (const auto &wire : module.wires_all) {
-        fout << " \\\n    output wire ";
+void VgaDebugGenerator::Generate_Outputs(const Module &module, Emitter &out) {
+    stats.macro_lines += 1 + WiresAll(module).size();
+    out << "\n\n`define VGA_DBG_" << module.name << "_Outputs";
+    for (const auto &wire : WiresAll(module)) {
+        out << " \\\n    output wire ";
         if (wire.len_bits > 1) {
-            fout << "[" << wire.len_bits - 1 << ":0] ";
+            out << "[" << wire.len_bits - 1 << ":0] ";
         }
-        fout << "dbg_" << wire.full_name << ",";
+        out << "dbg_" << wire.full_name << ",";
     }
 }
-void VgaDebugGenerator::Generate_Assignments(const Module &module, std::ofstream &fout) {
-    fout << "\n\n`define VGA_DBG_" << module.name << "_Assignments";
-    for (const auto &wire : module.wires) {
-        fout << " \\\n    assign dbg_" << wire.full_name << " = " << wire.code_name << ";";
+void VgaDebugGenerator::Generate_Assignments(const Module &module, Emitter &out) {
+    stats.macro_lines += 1 + Wires(module).size();
+    out << "\n\n`define VGA_DBG_" << module.name << "_Assignments";
+    for (const auto &wire : Wires(module)) {
+        out << " \\\n    assign dbg_" << wire.full_name << " = " << wire.code_name << ";";
     }
 }
-void VgaDebugGenerator::Generate_Arguments(const Module &module, std::ofstream &fout) {
-    fout << "\n\n`define VGA_DBG_" << module.name << "_Arguments";
-    for (const auto &wire : module.wires_all) {
-        fout << " \\\n    .dbg_" << wire.full_name << "(dbg_" << wire.full_name << "),";
+void VgaDebugGenerator::Generate_Arguments(const Module &module, Emitter &out) {
+    stats.macro_lines += 1 + WiresAll(module).size();
+    out << "\n\n`define VGA_DBG_" << module.name << "_Arguments";
+    for (const auto &wire : WiresAll(module)) {
+        out << " \\\n    .dbg_" << wire.full_name << "(dbg_" << wire.full_name << "),";
     }
 }
-void VgaDebugGenerator::Generate_Declaration(const Module &module, std::ofstream &fout) {
-    fout << "\n\n`define VGA_DBG_" << module.name << "_Declaration";
-    for (const auto &wire : module.wires) {
-        fout << " \\\n    wire ";
+void VgaDebugGenerator::Generate_Declaration(const Module &module, Emitter &out) {
+    stats.macro_lines += 1 + Wires(module).size();
+    out << "\n\n`define VGA_DBG_" << module.name << "_Declaration";
+    for (const auto &wire : Wires(module)) {
+        out << " \\\n    wire ";
         if (wire.len_bits > 1) {
-            fout << "[" << wire.len_bits - 1 << ":0] ";
+            out << "[" << wire.len_bits - 1 << ":0] ";
         }
-        fout << "dbg_" << wire.full_name << ";";
+        out << "dbg_" << wire.full_name << ";";
     }
 }
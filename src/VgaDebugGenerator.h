@@ -1,44 +1,209 @@
 #pragma once
 
-#include <fstream>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "Config.h"
+#include "Emitter.h"
+#include "Estimate.h"
+#include "Renderer.h"
+#include "Stats.h"
+#include "StringPool.h"
 #include "Template.h"
 #include "Wire.h"
 
+// an output file generated in memory
+struct Artifact {
+    std::string file_name;
+    std::string kind; // "memory file", "Verilog file", "debug header file" or "font file"
+    std::string content;
+};
+
+struct GeneratorError {
+    std::string phase; // the phase in 'Stats::phases' where the error happened
+    std::string message;
+};
+
+struct GenerateResult {
+    bool ok = false;
+    std::vector<Artifact> artifacts; // empty if not 'ok'
+    std::vector<GeneratorError> errors;
+    std::vector<std::string> warnings; // exceeded limits and a '.mem' file VgaDisplay can't load, see 'Estimate'
+};
+
 class VgaDebugGenerator {
+    friend class GeneratorBench;
+
 private:
-    Config config;
-    Template templte;
-    std::unordered_map<std::string, Module> modules;
-    int vga_size;
+    // shared with the caller of 'GenerateFrom', so it is never modified
+    std::shared_ptr<const Config> config = std::make_shared<const Config>();
+    // attributes of wires of groups, see 'Config::ResolveAttrs'
+    std::unordered_map<uint64_t, WireAttrs> resolved_attrs;
+    std::shared_ptr<const Template> templte;
+    // ordered, so that the generated code is deterministic
+    std::map<std::string, Module, std::less<>> modules;
+    std::vector<Wire> wires; // see 'Module' for the layout
+    StringPool names; // resolved names of 'wires'
+    bool generated_vga; // 'VgaController' and 'VgaDisplay' are generated for 'timing', see 'Config::vga_mode'
+    VgaTiming timing;
+    int row_stride; // characters between rows in the RAM, a power of two if 'generated_vga'
+    int vga_size; // characters of a page in the RAM, including those between rows
     int vga_size_pow2;
     int vga_size_log2;
+    int page_count; // pages of the template, each takes 'vga_size_pow2' characters of the RAM
+    int page_bits; // width of the page select input, 0 if there is only one page
+    int lane_bits; // log2 of 'Config::lanes', the low bits of a character's address select its lane
+    int code_bits; // width of a character before 'Hex2Ascii', 5 if a sign is shown, otherwise a nibble
+    std::vector<unsigned char> glyphs; // characters of the compact font by index, see 'Config::compact_font'
+    // what each character is stored as in the character RAM, its index in 'glyphs' or itself if the font isn't
+    // compact, -1 if the template can't show it
+    std::array<int, 256> glyph_of;
+    int glyph_bits; // width of an index of 'glyphs'
+
+    uint64_t config_hash = 0;
+    uint64_t template_hash = 0;
+    uint64_t font_hash = 0; // of 'Config::font_file' if the font is compact, which is an input then
+    std::vector<std::string> output_files;
+
+    std::ostream *out_stream = &std::cout;
+    std::ostream *err_stream = &std::cerr;
+    TemplateCache *template_cache = nullptr;
+
+    Stats stats;
+    StatsFormat stats_format = StatsFormat::None;
+    Estimate estimate;
+    StatsFormat report_format = StatsFormat::None;
+    int pipeline_fan_in = 0; // of the pipelined scan tree, 0 if it is not pipelined
+
+    std::vector<Artifact> *captured_outputs = nullptr; // if set, outputs go here instead of 'output_dir'
 
 public:
-    void Run(const std::string &config_file);
+    VgaDebugGenerator() = default;
+    // messages are printed to 'out' and errors to 'err', templates are loaded through 'template_cache' if given
+    VgaDebugGenerator(std::ostream &out, std::ostream &err, TemplateCache *template_cache = nullptr);
+
+    // unless 'force' is set, generation is skipped if the inputs are the same as those of the last run,
+    // returns false if there is any error
+    bool Run(const std::string &config_file, bool force = false);
+
+    // Keeps running and regenerates whenever the config file or its template file is modified, only stages
+    // affected by the modified file are re-run. Only supported on Linux, returns false if watching fails.
+    bool Watch(const std::string &config_file);
+
+    // Generates from contents instead of files, nothing is read from or written to the disk and nothing is
+    // printed. 'template_file' of the config is only used to name the template in errors.
+    GenerateResult GenerateFrom(std::string_view config_content, std::string_view template_content);
+    // the same, but from parsed inputs, so that they can be reused for many generations, also by generators
+    // on other threads
+    GenerateResult GenerateFrom(std::shared_ptr<const Config> parsed_config,
+        std::shared_ptr<const Template> parsed_template);
+
+    // statistics are printed after each generation if 'format' is not 'None'
+    void SetStatsFormat(StatsFormat format) { stats_format = format; }
+    // statistics of the last run
+    const Stats &GetStats() const { return stats; }
+    // the estimate of the generated hardware is printed after each generation if 'format' is not 'None'
+    void SetReportFormat(StatsFormat format) { report_format = format; }
+    // estimate of the last generation
+    const Estimate &GetEstimate() const { return estimate; }
+
+    // a software model of the hardware of the last successful generation, 'font' is as 'FrameRenderer'
+    FrameRenderer MakeRenderer(std::vector<unsigned char> font) const;
+    // Renders a frame for each line of 'trace_file' (see 'FrameRenderer::Apply') after the last successful
+    // generation, into 'frames/' in the output directory. Empty lines and lines starting with '#' are skipped.
+    bool RenderTrace(const std::string &trace_file, const std::string &font_file, FrameFormat format);
 
 private:
+    void RunPhase(const std::string &name, const std::function<void()> &func);
+
     void LoadConfig(const std::string &config_file);
 
     void LoadTemplate();
+    // sets 'font_hash', called by 'LoadTemplate'
+    void HashFont();
+
+    // hash of the config file, the template file, the version of this program and its sources
+    uint64_t InputsHash() const;
+    std::string CacheFile() const;
+    bool IsUpToDate() const;
+    void SaveCache() const;
 
     void ProcessConfig();
 
     void ProcessModules(const std::string &name);
+    void ProcessModule(const std::string &name, std::vector<Wire> &sorted_wires);
+
+    WireRange Wires(const Module &module) const;
+    WireRange WiresAll(const Module &module) const;
 
     void Generate();
+    // fills 'estimate' from the resolved wires and the generated scan, and checks it against the limits
+    void EstimateResources();
+    // index of the first character of 'wire' in the character RAM
+    int CellOf(const Wire &wire) const;
+    // characters in the character RAM
+    int RamCells() const;
+    // initial content of the character RAM, one byte per character
+    std::vector<unsigned char> MemImage() const;
     void Generate_Mem();
+    // the characters in the template and those the values of its wires may have, and 'glyph_of'
+    void CollectGlyphs();
+    // name of the font read by the generated display
+    std::string FontMemName() const;
+    // the compact font, from 'Config::font_file'
+    void Generate_Font();
     void Generate_VgaDebugger();
+    // the nibble written to a lane, 'wire' is null if the character of the lane is kept
+    struct ScanNibble {
+        const Wire *wire = nullptr;
+        int index = 0;
+    };
+    // a word of the character RAM written when the scan counter of 'VgaDebugger' is 'key'
+    struct ScanArm {
+        int key;
+        int addr;
+        std::vector<ScanNibble> lanes;
+    };
+    // words with nibbles, in the order of the first nibble of each word, 'key' is the same as 'addr'
+    std::vector<ScanArm> ScanArms(WireRange wires_all) const;
+    // 'snap_' copies of all wires in the domain of 'clk', sampled on 'src_clk', see 'Config::cdc_snapshot'
+    void Generate_Snapshot(WireRange wires_all, Emitter &out);
+    // the scan loop of 'VgaDebugger', which visits every cell or only cells of nibbles, see 'ScanMode'
+    void Generate_FullScan(WireRange wires_all, Emitter &out);
+    void Generate_DynamicScan(WireRange wires_all, Emitter &out);
+    // the selection of 'arms' by 'key' as a pipelined tree, 'addr_rom' is false if the key is the address
+    void Generate_PipelinedScan(const std::vector<ScanArm> &arms, const std::string &key, int key_bits,
+        bool addr_rom, Emitter &out);
+    // assigns the lanes of 'arm' to 'dynamic_hex' and 'display_wen'
+    void Generate_ArmWrite(const ScanArm &arm, Emitter &out);
+    // converts the character of each lane in 'hex' to 'display_w_data'
+    void Generate_Hex2Ascii(const std::string &hex, Emitter &out);
+    // the pipelined binary to decimal converter, used for decimal wires
+    void Generate_Bin2Dec(Emitter &out);
+    // a 'Bin2Dec' for each decimal wire, whose digits are 'dec_' and sign is 'neg_'
+    void Generate_DecimalWires(WireRange wires_all, Emitter &out);
+    // character 'i' (from the most significant one) of 'wire' before 'Hex2Ascii'
+    void Generate_Nibble(const Wire &wire, int i, Emitter &out);
+    // for 'timing', only if 'generated_vga'
+    void Generate_VgaController();
+    // for several pages or lanes, or for 'timing' and the font size if 'generated_vga'
     void Generate_VgaDisplay();
-    void Generate_VgaInstance(std::ofstream &fout);
+    // the pixel path of the generated display, from the position to the colour
+    void Generate_TextPixel(Emitter &out);
+    void WriteOutput(Emitter &out, const std::string &file_name, const std::string &kind);
+    void Generate_VgaInstance(Emitter &out);
 
-    void Generate_Modules(std::ofstream &fout);
-    void Generate_Outputs(const Module &module, std::ofstream &fout);
-    void Generate_Assignments(const Module &module, std::ofstream &fout);
-    void Generate_Arguments(const Module &module, std::ofstream &fout);
-    void Generate_Declaration(const Module &module, std::ofstream &fout);
+    void Generate_Modules(Emitter &out);
+    void Generate_Outputs(const Module &module, Emitter &out);
+    void Generate_Assignments(const Module &module, Emitter &out);
+    void Generate_Arguments(const Module &module, Emitter &out);
+    void Generate_Declaration(const Module &module, Emitter &out);
 };
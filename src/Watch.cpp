@@ -0,0 +1,218 @@
+#include "VgaDebugGenerator.h"
+
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <set>
+#include <string>
+#include <tuple>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+namespace {
+
+// Files are watched through their directories, since many editors save a file by renaming a new one to it.
+class FileWatcher {
+public:
+    FileWatcher() : fd(inotify_init1(IN_CLOEXEC)) {}
+    ~FileWatcher() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool Ok() const { return fd >= 0; }
+
+    // returns index of the file, or -1 if it can't be watched
+    int Add(const std::string &path) {
+        auto file_path = std::filesystem::absolute(path).lexically_normal();
+        int wd = inotify_add_watch(fd, file_path.parent_path().c_str(),
+            IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd < 0) {
+            return -1;
+        }
+        files.push_back({ wd, file_path.filename().string() });
+        return static_cast<int>(files.size()) - 1;
+    }
+
+    void Clear() {
+        // files in the same directory share a watch, which is removed once
+        std::set<int> wds;
+        for (const auto &file : files) {
+            wds.insert(file.wd);
+        }
+        for (int wd : wds) {
+            inotify_rm_watch(fd, wd);
+        }
+        files.clear();
+    }
+
+    // blocks until some files are modified, then collects all events in the next 'settle_ms' milliseconds
+    // and returns a mask of modified files
+    unsigned Wait(int settle_ms) {
+        unsigned mask = 0;
+        int timeout = -1;
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            pollfd pfd { fd, POLLIN, 0 };
+            int ret = poll(&pfd, 1, timeout);
+            if (ret == 0) {
+                return mask;
+            } else if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return mask;
+            }
+            auto len = read(fd, buffer, sizeof(buffer));
+            for (char *p = buffer; p < buffer + len; ) {
+                auto event = reinterpret_cast<const inotify_event *>(p);
+                for (int i = 0; i < files.size(); i++) {
+                    if (event->wd == files[i].wd && event->len > 0 && files[i].name == event->name) {
+                        mask |= 1u << i;
+                    }
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+            if (mask != 0) {
+                timeout = settle_ms;
+            }
+        }
+    }
+
+private:
+    struct File {
+        int wd;
+        std::string name;
+    };
+
+    int fd;
+    std::vector<File> files;
+};
+
+}
+
+bool VgaDebugGenerator::Watch(const std::string &config_file) {
+    FileWatcher watcher;
+    if (!watcher.Ok()) {
+        *err_stream << "Failed to initialize inotify" << std::endl;
+        return false;
+    }
+
+    bool has_config = false;
+    bool has_template = false;
+    bool watching = false;
+    std::string watched_template;
+    std::string watched_font;
+    int template_index = -1;
+    int font_index = -1;
+    auto stage_ms = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    bool config_changed = true;
+    bool template_changed = true;
+    bool font_changed = false;
+    while (true) {
+        auto start = std::chrono::steady_clock::now();
+        stats = Stats {};
+        try {
+            if (config_changed) {
+                auto old_template_file = config->template_file;
+                auto old_layout = std::make_tuple(config->header_lines, config->template_width,
+                    config->template_height);
+                RunPhase("LoadConfig", [&]() { LoadConfig(config_file); });
+                has_config = true;
+                // the parsed template can be kept if the config doesn't change how it is parsed
+                template_changed |= !has_template || config->template_file != old_template_file
+                    || std::make_tuple(config->header_lines, config->template_width, config->template_height)
+                        != old_layout;
+            }
+            if (template_changed) {
+                has_template = false;
+                RunPhase("LoadTemplate", [&]() { LoadTemplate(); });
+                has_template = true;
+            } else if (config_changed || font_changed) {
+                // the compact font is an input, see 'InputsHash'
+                HashFont();
+            }
+            RunPhase("ProcessConfig", [&]() { ProcessConfig(); });
+            RunPhase("ProcessModules", [&]() { ProcessModules(config->module_name); });
+            RunPhase("Generate", [&]() {
+                Generate();
+                SaveCache();
+            });
+            stats.Print(*out_stream, stats_format);
+            estimate.Print(*out_stream, report_format);
+            std::string changed;
+            for (const auto &[is_changed, what] : { std::make_pair(config_changed, "config"),
+                std::make_pair(template_changed, "template"), std::make_pair(font_changed, "font") }) {
+                if (is_changed) {
+                    changed += (changed.empty() ? "" : " and ") + std::string(what);
+                }
+            }
+            *out_stream << "Regenerated in " << std::fixed << std::setprecision(3) << stage_ms(start) << " ms ("
+                << changed << " changed)" << std::endl;
+        } catch (const std::string &error_msg) {
+            *err_stream << error_msg << std::endl;
+        } catch (const std::exception &e) {
+            *err_stream << e.what() << std::endl;
+        }
+
+        // the template file is not known until the config file is loaded successfully, and the font is only
+        // read by the generator if it is compact
+        auto template_file = has_config ? config->template_file : "";
+        auto font_file = has_config && config->compact_font ? config->font_file : "";
+        if (!watching || template_file != watched_template || font_file != watched_font) {
+            watcher.Clear();
+            std::string files = "'" + config_file + "'";
+            bool ok = watcher.Add(config_file) >= 0;
+            // the index of each file is its bit in the mask of 'Wait'
+            auto add = [&](const std::string &file, bool last) {
+                if (file.empty()) {
+                    return -1;
+                }
+                files += (last ? " and '" : ", '") + file + "'";
+                int index = watcher.Add(file);
+                ok &= index >= 0;
+                return index;
+            };
+            template_index = add(template_file, font_file.empty());
+            font_index = add(font_file, true);
+            if (!ok) {
+                *err_stream << "Failed to watch " << files << std::endl;
+                return false;
+            }
+            watching = true;
+            watched_template = template_file;
+            watched_font = font_file;
+            *out_stream << "Watching " << files << std::endl;
+        }
+
+        auto mask = watcher.Wait(50);
+        if (mask == 0) {
+            *err_stream << "Failed to wait for file changes" << std::endl;
+            return false;
+        }
+        auto is_modified = [mask](int index) { return index >= 0 && ((mask >> index) & 1); };
+        config_changed = is_modified(0) || !has_config;
+        template_changed = is_modified(template_index) || !has_template;
+        font_changed = is_modified(font_index);
+    }
+}
+
+#else
+
+bool VgaDebugGenerator::Watch(const std::string &config_file) {
+    *err_stream << "Watch mode is only supported on Linux" << std::endl;
+    return false;
+}
+
+#endif
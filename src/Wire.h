@@ -1,23 +1,51 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
+// how the value of a wire is shown, by the characters of its placeholder in the template:
+// '0' for hex digits, '#' for unsigned decimal digits, '-' and '#' for a sign and decimal digits, 'b' for bits
+enum class WireFormat {
+    Hex,
+    Unsigned,
+    Signed,
+    Binary,
+};
+
+// 'name' is a view into the MappedFile of the Template, so the Template must outlive its wires, and the other
+// names are views into the StringPool of the generator
 struct Wire {
-    std::string name;
-    std::string full_name;
-    std::string code_name;
-    std::string module_name;
-    int len_hex;
+    std::string_view name;
+    std::string_view full_name;
+    std::string_view code_name;
+    std::string_view module_name;
+    int len_hex; // characters of the placeholder, which are hex digits unless 'format' says otherwise
     int len_bits;
-    int temp_start_pos;
+    WireFormat format = WireFormat::Hex;
+    int page = 0;
+    int temp_start_pos; // in the page
     int temp_end_pos;
 };
 
+struct WireRange {
+    const Wire *first;
+    const Wire *last;
+
+    const Wire *begin() const { return first; }
+    const Wire *end() const { return last; }
+    int size() const { return static_cast<int>(last - first); }
+};
+
+// Every resolved wire is stored once in the generator's wire table, ordered by a pre-order walk of the
+// module hierarchy. So the wires of a module are [wires_begin, wires_end) in the table, and the wires of
+// the module and all its submodules are [wires_begin, wires_all_end).
 struct Module {
     std::string name;
     std::string parent_name;
     std::vector<std::string> submodule_names;
-    std::vector<Wire> wires;
-    std::vector<Wire> wires_all;
+    std::vector<int> wire_ids; // indices into the unordered wire table, only used before 'ProcessModules'
+    int wires_begin = 0;
+    int wires_end = 0;
+    int wires_all_end = 0;
 };
@@ -0,0 +1,162 @@
+// Generates from 'config.json' and 'template.txt' of a case directory and compares each artifact with the file
+// of the same name in 'expected/' of the case, and the text estimate with 'expected/estimate.txt'. If the case
+// has a 'trace.txt', the character grid of each of its frames is compared with 'expected/frames.txt'.
+// '--update' rewrites the expected files instead
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "VgaDebugGenerator.h"
+
+namespace {
+
+bool ReadFile(const std::filesystem::path &path, std::string &content) {
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin) {
+        return false;
+    }
+    std::ostringstream ss;
+    ss << fin.rdbuf();
+    content = ss.str();
+    return true;
+}
+
+// 1-based line of the first difference
+int FirstDifferentLine(const std::string &a, const std::string &b) {
+    int line = 1;
+    for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+        if (a[i] != b[i]) {
+            return line;
+        }
+        if (a[i] == '\n') {
+            line++;
+        }
+    }
+    return line;
+}
+
+bool RunCase(const std::filesystem::path &case_dir, bool update) {
+    std::string config_content, template_content;
+    if (!ReadFile(case_dir / "config.json", config_content) ||
+        !ReadFile(case_dir / "template.txt", template_content)) {
+        std::cerr << case_dir.string() << ": can't read 'config.json' or 'template.txt'" << std::endl;
+        return false;
+    }
+    VgaDebugGenerator generator;
+    auto result = generator.GenerateFrom(config_content, template_content);
+    if (!result.ok) {
+        for (const auto &error : result.errors) {
+            std::cerr << case_dir.string() << ": " << error.message << std::endl;
+        }
+        return false;
+    }
+    std::ostringstream estimate;
+    generator.GetEstimate().Print(estimate, StatsFormat::Text);
+    result.artifacts.emplace_back(Artifact { "estimate.txt", "estimate", estimate.str() });
+    std::string trace;
+    if (ReadFile(case_dir / "trace.txt", trace)) {
+        // glyphs aren't in the grid, so no font is needed
+        auto renderer = generator.MakeRenderer({});
+        std::istringstream fin(trace);
+        std::ostringstream frames;
+        std::string line, error;
+        int lineno = 0;
+        while (std::getline(fin, line)) {
+            ++lineno;
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            if (!renderer.Apply(line, error)) {
+                std::cerr << case_dir.string() << "/trace.txt:" << lineno << ": " << error << std::endl;
+                return false;
+            }
+            frames << "# " << line << '\n' << renderer.Grid();
+        }
+        result.artifacts.emplace_back(Artifact { "frames.txt", "frames", frames.str() });
+    }
+
+    auto expected_dir = case_dir / "expected";
+    if (update) {
+        std::filesystem::remove_all(expected_dir);
+        std::filesystem::create_directories(expected_dir);
+        for (const auto &artifact : result.artifacts) {
+            auto path = expected_dir / artifact.file_name;
+            std::ofstream fout(path, std::ios::binary);
+            fout << artifact.content;
+            if (!fout) {
+                std::cerr << "Failed to write '" << path.string() << "'" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ok = true;
+    std::set<std::string> generated;
+    for (const auto &artifact : result.artifacts) {
+        generated.insert(artifact.file_name);
+        auto path = expected_dir / artifact.file_name;
+        std::string expected;
+        if (!ReadFile(path, expected)) {
+            std::cerr << path.string() << ": unexpected " << artifact.kind << std::endl;
+            ok = false;
+        } else if (expected != artifact.content) {
+            std::cerr << path.string() << ": differs at line " << FirstDifferentLine(expected, artifact.content)
+                << std::endl;
+            ok = false;
+        }
+    }
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(expected_dir, ec)) {
+        if (!generated.count(entry.path().filename().string())) {
+            std::cerr << entry.path().string() << ": not generated" << std::endl;
+            ok = false;
+        }
+    }
+    if (ec) {
+        std::cerr << expected_dir.string() << ": " << ec.message() << std::endl;
+        ok = false;
+    }
+    for (const auto &warning : result.warnings) {
+        std::cerr << case_dir.string() << ": warning: " << warning << std::endl;
+    }
+    return ok;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    bool update = false;
+    std::vector<std::string> case_dirs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--update") {
+            update = true;
+        } else {
+            case_dirs.push_back(arg);
+        }
+    }
+    if (case_dirs.empty()) {
+        std::cerr << "Usage: ./vga_debug_generator_tests [--update] <case-dir>..." << std::endl;
+        return 1;
+    }
+
+    bool ok = true;
+    for (const auto &arg : case_dirs) {
+        try {
+            ok = RunCase(arg, update) && ok;
+        } catch (const std::string &error_msg) {
+            std::cerr << arg << ": " << error_msg << std::endl;
+            ok = false;
+        } catch (const std::exception &e) {
+            std::cerr << arg << ": " << e.what() << std::endl;
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
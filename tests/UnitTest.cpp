@@ -0,0 +1,428 @@
+// Checks of the generator which comparing generated files can't cover, each is run by its name:
+//   ./vga_debug_generator_unit_tests <test-name>...
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Config.h"
+#include "Estimate.h"
+#include "Stats.h"
+#include "VgaDebugGenerator.h"
+#include "nlohmann/json.hpp"
+
+namespace {
+
+bool Check(bool condition, const std::string &what) {
+    if (!condition) {
+        std::cerr << "Failed: " << what << std::endl;
+    }
+    return condition;
+}
+
+bool WriteFile(const std::filesystem::path &path, const std::string &content) {
+    std::ofstream fout(path, std::ios::binary);
+    fout << content;
+    return static_cast<bool>(fout);
+}
+
+// a directory under the temporary directory, removed with its files when the test ends
+class TempDir {
+public:
+    TempDir() {
+        auto ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+        path = std::filesystem::temp_directory_path() / ("vga_dbg_gen_test_" + std::to_string(ticks));
+        std::filesystem::create_directories(path);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    std::filesystem::path path;
+};
+
+// whether each output of the last run is rewritten, by its name
+bool Written(const VgaDebugGenerator &generator, const std::string &file_name) {
+    for (const auto &output : generator.GetStats().outputs) {
+        if (output.file_name == file_name) {
+            return output.written;
+        }
+    }
+    return false;
+}
+
+// 'Run' skips generation if the inputs are not changed, and doesn't rewrite outputs whose content is the same
+bool TestCache() {
+    TempDir dir;
+    auto template_file = (dir.path / "template.txt").string();
+    auto config_file = (dir.path / "config.json").string();
+    std::ostringstream config;
+    config << R"({"module_name": "Core", "template_file": ")" << template_file << R"(", "output_dir": ")"
+        << (dir.path / "out").string() << R"(/", "mem_file": "dbg.mem", "dbg_header": "dbg.vh", )"
+        << R"("header_lines": 1, "template_width": 40, "template_height": 4})";
+    if (!WriteFile(config_file, config.str()) || !WriteFile(template_file, "Cache test\npc: 00000000\n")) {
+        return Check(false, "write the inputs");
+    }
+    std::filesystem::create_directories(dir.path / "out");
+
+    bool ok = true;
+    std::ostringstream out, err;
+    VgaDebugGenerator generator(out, err);
+    ok &= Check(generator.Run(config_file), "first run");
+    ok &= Check(Written(generator, "dbg.mem") && Written(generator, "VgaDebugger.v")
+        && Written(generator, "dbg.vh"), "first run writes every output");
+
+    out.str("");
+    ok &= Check(generator.Run(config_file), "second run");
+    ok &= Check(out.str().find("are up to date") != std::string::npos, "second run is up to date");
+
+    // only the constant text is changed, so only the character RAM image is
+    WriteFile(template_file, "Cache TEST\npc: 00000000\n");
+    out.str("");
+    ok &= Check(generator.Run(config_file), "run after the template is changed");
+    ok &= Check(out.str().find("are up to date") == std::string::npos, "a changed template is regenerated");
+    ok &= Check(Written(generator, "dbg.mem"), "the changed image is rewritten");
+    ok &= Check(!Written(generator, "VgaDebugger.v") && !Written(generator, "dbg.vh"),
+        "unchanged outputs are kept");
+
+    std::filesystem::remove(dir.path / "out" / "dbg.vh");
+    out.str("");
+    ok &= Check(generator.Run(config_file), "run after an output is removed");
+    ok &= Check(Written(generator, "dbg.vh") && !Written(generator, "dbg.mem"),
+        "only the removed output is written");
+
+    out.str("");
+    ok &= Check(generator.Run(config_file, true), "forced run");
+    ok &= Check(out.str().find("are up to date") == std::string::npos && !Written(generator, "dbg.mem"),
+        "a forced run regenerates but keeps unchanged outputs");
+    if (!ok) {
+        std::cerr << err.str();
+    }
+    return ok;
+}
+
+// names and paths with quotes, backslashes and bytes which aren't UTF-8 are printed as valid JSON
+bool TestStatsJson() {
+    Stats stats;
+    stats.phases.emplace_back(PhaseStats { "Load \"config\"", 1.5, 1024 });
+    stats.outputs.emplace_back(OutputStats { "C:\\out\\dbg.mem", 100, true, 0.25 });
+    stats.outputs.emplace_back(OutputStats { "latin1_\xe9.v", 10, false, 0.5 });
+    std::ostringstream out;
+    stats.Print(out, StatsFormat::Json);
+    auto json = nlohmann::json::parse(out.str(), nullptr, false);
+    if (!Check(!json.is_discarded(), "the statistics are valid JSON: " + out.str())) {
+        return false;
+    }
+    bool ok = Check(json["phases"][0]["name"] == "Load \"config\"", "a quoted phase name");
+    ok &= Check(json["outputs"][0]["file"] == "C:\\out\\dbg.mem", "a path with backslashes");
+    ok &= Check(json["outputs"][1]["file"].get<std::string>().rfind("latin1_", 0) == 0,
+        "a name which isn't UTF-8");
+    return ok;
+}
+
+// the same for the estimate, whose warnings may quote paths
+bool TestEstimateJson() {
+    Estimate estimate;
+    estimate.modules.emplace_back(ModuleEstimate { "Core\\top", 0, 2, 33 });
+    estimate.wires.emplace_back(WireEstimate { "pc\"q", 0, 40 });
+    estimate.warnings.emplace_back("Can't load 'C:\\out\\dbg.coe'\twith $readmemh");
+    std::ostringstream out;
+    estimate.Print(out, StatsFormat::Json);
+    auto json = nlohmann::json::parse(out.str(), nullptr, false);
+    if (!Check(!json.is_discarded(), "the estimate is valid JSON: " + out.str())) {
+        return false;
+    }
+    bool ok = Check(json["modules"][0]["name"] == "Core\\top", "a module name with a backslash");
+    ok &= Check(json["wires"][0]["name"] == "pc\"q", "a quoted wire name");
+    ok &= Check(json["warnings"][0] == "Can't load 'C:\\out\\dbg.coe'\twith $readmemh", "a warning with a path");
+    return ok;
+}
+
+// glyphs narrower than 8 pixels show the high bits of their rows, and a changed value re-renders its cell
+bool TestRenderPixels() {
+    RenderLayout layout { 2, 1, 2, 2, 1, 4, 2 };
+    std::vector<unsigned char> font(256 * 2, 0);
+    font['A' * 2] = 0xf0;
+    font['A' * 2 + 1] = 0x9f;
+    font['0' * 2] = 0x60;
+    font['0' * 2 + 1] = 0x90;
+    font['5' * 2] = 0xf0;
+    font['5' * 2 + 1] = 0x1f;
+    FrameRenderer renderer({ 'A', '0' }, layout, { RenderWire { "v", 1, 4, 1 } }, font);
+    auto rows = [&] {
+        const auto &pixels = renderer.Pixels();
+        std::string text;
+        for (size_t i = 0; i < pixels.size(); i++) {
+            text += pixels[i] ? '#' : '.';
+            text += (i + 1) % renderer.PixelWidth() == 0 ? "|" : "";
+        }
+        return text;
+    };
+    bool ok = Check(renderer.PixelWidth() == 8 && renderer.PixelHeight() == 2, "2x1 characters of 4x2 pixels");
+    ok &= Check(rows() == "####.##.|#..##..#|", "the template: " + rows());
+    ok &= Check(renderer.SetValue("v", 5), "setting 'v'");
+    ok &= Check(renderer.Grid() == "A5\n", "the grid after setting 'v': " + renderer.Grid());
+    ok &= Check(rows() == "########|#..#...#|", "the pixels after setting 'v': " + rows());
+    return ok;
+}
+
+// both parsers of the config, with errors kept from the output of the test
+std::optional<Config> ParseBoth(const std::string &content, bool dom, std::string &errors) {
+    std::istringstream fin(content);
+    std::ostringstream err;
+    auto config = dom ? Config::FromDom(fin, err) : Config::From(fin, err);
+    errors = err.str();
+    return config;
+}
+
+// a wire listed twice in a submodule is kept once, but one listed by two submodules is an error
+bool TestSubmoduleOwners() {
+    const std::string head = R"({"module_name": "Core", "template_file": "t.txt", "mem_file": "m.mem", )"
+        R"("dbg_header": "d.vh", "submodule": [)";
+    const std::string twice = head + R"({"name": "A", "wires": {"": ["x", "y", "x"]}}]})";
+    const std::string shared = head
+        + R"({"name": "A", "wires": {"": ["x"]}}, {"name": "B", "wires": {"": ["x"]}}]})";
+    bool ok = true;
+    for (bool dom : { false, true }) {
+        std::string parser = dom ? "FromDom" : "From", errors;
+        auto config = ParseBoth(twice, dom, errors);
+        ok &= Check(config.has_value(), parser + " accepts a wire listed twice in a submodule: " + errors);
+        if (config) {
+            ok &= Check(config->submodule.at("A").wires.size() == 2, parser + " keeps the wire once");
+        }
+        ok &= Check(!ParseBoth(shared, dom, errors).has_value(), parser + " rejects a wire of two submodules");
+    }
+    return ok;
+}
+
+// every field of 'config' in a fixed order, strings by their values instead of their ids
+std::string Describe(const Config &config) {
+    std::ostringstream out;
+    auto str = [&](int id) { return id < 0 ? std::string("-") : std::string(config.strings[id]); };
+    auto key = [&](uint64_t wire_key) {
+        auto wire_id = static_cast<int>(static_cast<uint32_t>(wire_key));
+        return str(static_cast<int>(wire_key >> 32)) + "." + str(wire_id);
+    };
+    auto attrs = [&](const WireAttrs &attrs) {
+        return str(attrs.prefix) + " " + str(attrs.suffix) + " " + str(attrs.name) + " "
+            + std::to_string(attrs.len_bits) + " " + str(attrs.submodule);
+    };
+    const auto &limits = config.limits;
+    const auto &timing = config.vga_timing;
+    out << config.template_file << "|" << config.output_dir << "|" << config.mem_file << "|" << config.dbg_header
+        << "|" << config.module_name << "|" << config.header_lines << " " << config.template_width << " "
+        << config.template_height << "|" << static_cast<int>(config.mem_format) << " " << config.mem_word_bytes
+        << " " << static_cast<int>(config.scan_mode) << " " << config.pipeline_stages << " " << config.lanes
+        << " " << config.cdc_snapshot << "|" << limits.bram_bits << " " << limits.luts << " "
+        << limits.logic_levels << " " << limits.mux_inputs << " " << limits.refresh_cycles << "|"
+        << config.vga_mode << "|" << timing.h_visible << " " << timing.h_front_porch << " " << timing.h_sync << " "
+        << timing.h_back_porch << " " << timing.v_visible << " " << timing.v_front_porch << " " << timing.v_sync
+        << " " << timing.v_back_porch << " " << timing.h_sync_positive << " " << timing.v_sync_positive << "|"
+        << config.font_file << " " << config.font_width << " " << config.font_height << " "
+        << config.compact_font << " " << config.display_pipeline << "\n";
+    for (const auto &[name, prefixes] : { std::make_pair("block_prefix", &config.block_prefix),
+        std::make_pair("block_suffix", &config.block_suffix) }) {
+        for (const auto &[block, value] : std::map<std::string, std::string>(prefixes->begin(), prefixes->end())) {
+            out << name << " " << block << " " << value << "\n";
+        }
+    }
+    std::map<std::string, std::string> wire_attrs;
+    for (const auto &[wire_key, value] : config.wire_attrs) {
+        wire_attrs[key(wire_key)] = attrs(value);
+    }
+    for (const auto &[wire, value] : wire_attrs) {
+        out << "wire " << wire << " " << value << "\n";
+    }
+    for (const auto &group : config.groups) {
+        out << "group " << group.name << " " << attrs(group.attrs) << ":";
+        for (auto wire_key : group.wires) {
+            out << " " << key(wire_key);
+        }
+        out << "\n";
+    }
+    for (const auto &[name, submodule] : config.submodule) {
+        out << "submodule " << name << " " << submodule.parent_name << ":";
+        for (const auto &[block, wire] : submodule.wires) {
+            out << " " << block << "." << wire;
+        }
+        for (int group_id : submodule.groups) {
+            out << " *" << config.groups[group_id].name;
+        }
+        out << "\n";
+    }
+    std::map<std::string, std::string> wire_groups;
+    for (const auto &[wire_key, group_ids] : config.wire_groups) {
+        for (int group_id : group_ids) {
+            wire_groups[key(wire_key)] += " " + config.groups[group_id].name;
+        }
+    }
+    for (const auto &[wire, groups] : wire_groups) {
+        out << "in_groups " << wire << ":" << groups << "\n";
+    }
+    return out.str();
+}
+
+// images read by $readmemh must have words of 'lanes' characters, as the RAM of VgaDisplay
+bool TestMemWordBytes() {
+    const std::string head = R"({"module_name": "Core", "template_file": "t.txt", "mem_file": "m.mem", )"
+        R"("dbg_header": "d.vh", "template_width": 40, "template_height": 4, )";
+    const std::string template_content = "Words\npc: 00000000\n";
+    const std::pair<std::string, bool> configs[] = { // the fields, and whether they are accepted
+        { R"("mem_word_bytes": 2)", false },
+        { R"("mem_word_bytes": 2, "vga_mode": "640x480")", false },
+        { R"("mem_word_bytes": 4, "mem_format": "hex_sparse", "lanes": 2)", false },
+        { R"("mem_word_bytes": 2, "mem_format": "hex_sparse", "lanes": 2)", true },
+        { R"("mem_word_bytes": 1, "lanes": 4)", true },
+        { R"("mem_word_bytes": 2, "mem_format": "coe")", true },
+        { R"("mem_word_bytes": 8, "mem_format": "bin")", true },
+    };
+    bool ok = true;
+    for (const auto &[fields, accepted] : configs) {
+        VgaDebugGenerator generator;
+        auto result = generator.GenerateFrom(head + fields + "}", template_content);
+        bool names_field = !result.errors.empty()
+            && result.errors[0].message.find("mem_word_bytes") != std::string::npos;
+        ok &= Check(result.ok == accepted && (accepted || names_field),
+            fields + (accepted ? " is accepted" : " is rejected for 'mem_word_bytes'"));
+    }
+    return ok;
+}
+
+// the result of a parser of the config: the errors and the parsed fields, or the exception
+std::string ParseResult(const std::string &content, bool dom) {
+    std::istringstream fin(content);
+    std::ostringstream err;
+    try {
+        auto config = dom ? Config::FromDom(fin, err) : Config::From(fin, err);
+        return err.str() + (config ? Describe(*config) : "(no config)");
+    } catch (const std::exception &e) {
+        return std::string("exception: ") + e.what();
+    }
+}
+
+// 'Config::From' and 'Config::FromDom' give the same config or the same errors
+bool TestConfigParity() {
+    std::vector<std::pair<std::string, std::string>> configs; // name and content
+    std::string source_dir = VGA_DBG_GEN_SOURCE_DIR;
+    for (const auto &dir : { source_dir + "/config_example", source_dir + "/tests/cases" }) {
+        for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+            std::ifstream fin(entry.path() / "config.json", std::ios::binary);
+            std::ostringstream content;
+            content << fin.rdbuf();
+            configs.emplace_back((entry.path() / "config.json").string(), content.str());
+        }
+    }
+    // each field with a valid and a wrong value, and broken documents
+    const std::string head = R"({"module_name": "M", "template_file": "t", "mem_file": "m", "dbg_header": "d")";
+    const char *fields[] = {
+        R"("output_dir": "out/")", R"("output_dir": 1)",
+        R"("header_lines": 2)", R"("header_lines": 1.5)", R"("header_lines": "2")",
+        R"("header_lines": 4294967297)",
+        R"("template_width": 40, "template_height": 8)", R"("template_width": -1)",
+        R"("mem_format": "coe")", R"("mem_format": "txt")", R"("mem_format": 1)",
+        R"("mem_word_bytes": 4)", R"("mem_word_bytes": 3)",
+        R"("scan_mode": "dynamic")", R"("scan_mode": "partial")",
+        R"("pipeline_stages": 3)", R"("pipeline_stages": -1)", R"("pipeline_stages": "a")",
+        R"("lanes": 4)", R"("lanes": 3)", R"("lanes": -4294967294)",
+        R"("cdc_snapshot": true)", R"("cdc_snapshot": 1)",
+        R"("limits": {"luts": 5, "refresh_cycles": 9})", R"("limits": {"lut": 5})",
+        R"("limits": {"luts": 3000000000})",
+        R"("vga_mode": "1280x720")", R"("vga_mode": "1280x1024")",
+        R"("vga_timing": {"h_visible": 320, "v_sync_positive": 1})", R"("vga_timing": {"h_visibl": 320})",
+        R"("font_file": "f.mem", "font_width": 4, "font_height": 8)", R"("font_width": 3, "font_height": 12)",
+        R"("font_file": 1)",
+        R"("compact_font": true)", R"("compact_font": 1)",
+        R"("display_pipeline": true)", R"("display_pipeline": "yes")",
+        R"("block_prefix": {"Ex": "IdEx_"}, "block_suffix": {"Ex": "_ex"})", R"("block_prefix": ["Ex"])",
+        R"("len_bits": {"Ex": {"rd": 5}, "": {"x": 1}})", R"("len_bits": {"Ex": {"rd": "5"}})",
+        R"("len_bits": {"Ex": {"rd": 4294967300}})", R"("len_bits": {"Ex": 5})",
+        R"("wire_prefix": {"Ex": {"rd": "p_"}}, "wire_suffix": {"Ex": {"rd": "_s"}})",
+        R"("wire_prefix": {"Ex": {"rd": 1}})",
+        R"("wire_name": {"Ex": {"rd": "rd_q[0]"}})", R"("wire_name": {"Ex": "rd"})",
+        R"("wire_group": [{"name": "g", "wires": {"Ex": ["a", "b"]}}], "len_bits": {"*g": 3},)"
+            R"( "wire_prefix": {"*g": "g_"}, "wire_suffix": {"*g": "_g"})",
+        R"("len_bits": {"*g": 3})",
+        R"("wire_group": [{"wires": {"Ex": ["a"]}}])",
+        R"("wire_group": [{"name": "g", "wires": {"Ex": [1]}}])",
+        R"("wire_group": [{"name": "g", "wires": {"Ex": ["a"]}}, {"name": "g", "wires": {"Ex": ["b"]}}])",
+        R"("wire_group": [{"name": "g", "wires": {"Ex": ["a"]}}, {"name": "h", "wires": {"Ex": ["a"]}}])",
+        R"("submodule": [{"name": "A", "wires": {"Ex": ["a", "b"]}}, {"name": "B", "parent": "A", "wires": {}}])",
+        R"("submodule": [{"name": "A", "wires": {"*g": []}}],)"
+            R"( "wire_group": [{"name": "g", "wires": {"": ["a"]}}])",
+        R"("submodule": [{"name": "A", "wires": {"*g": ["a"]}}], "wire_group": [{"name": "g", "wires": {}}])",
+        R"("submodule": [{"name": "A", "wires": {"*g": []}}])",
+        R"("submodule": [{"name": "A", "wires": {"Ex": ["a"]}}, {"name": "A", "wires": {"Ex": ["b"]}}])",
+        R"("submodule": [{"name": "M", "wires": {"Ex": ["a"]}}])",
+        R"("submodule": [{"name": "A", "wires": ["a"]}])",
+        R"("submodule": [{"wires": {"Ex": ["a"]}}])",
+        R"("submodule": {"name": "A"})",
+        R"("unknown_field": [1, {"a": 2}])",
+        R"("module_name": "N")",
+    };
+    for (const char *field : fields) {
+        configs.emplace_back(field, head + ", " + field + "}");
+    }
+    for (const char *document : { "", "{\"a\": ", "[1, 2]", "5", R"({"module_name": "M"})",
+        R"({"template_file": 1, "mem_file": "m"})" }) {
+        configs.emplace_back(std::string("document ") + document, document);
+    }
+
+    bool ok = true;
+    for (const auto &[name, content] : configs) {
+        auto sax = ParseResult(content, false);
+        auto dom = ParseResult(content, true);
+        ok &= Check(sax == dom, name + ":\nFrom:\n" + sax + "\nFromDom:\n" + dom);
+    }
+    return ok;
+}
+
+const std::pair<std::string_view, std::function<bool()>> tests[] = {
+    { "cache", TestCache },
+    { "stats_json", TestStatsJson },
+    { "estimate_json", TestEstimateJson },
+    { "render_pixels", TestRenderPixels },
+    { "submodule_owners", TestSubmoduleOwners },
+    { "config_parity", TestConfigParity },
+    { "mem_word_bytes", TestMemWordBytes },
+};
+
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: ./vga_debug_generator_unit_tests <test-name>..." << std::endl;
+        return 1;
+    }
+    bool ok = true;
+    for (int i = 1; i < argc; i++) {
+        std::string_view name = argv[i];
+        auto it = std::find_if(std::begin(tests), std::end(tests), [&](const auto &test) {
+            return test.first == name;
+        });
+        if (it == std::end(tests)) {
+            std::cerr << "Unknown test '" << name << "'" << std::endl;
+            ok = false;
+            continue;
+        }
+        try {
+            ok = it->second() && ok;
+        } catch (const std::string &error_msg) {
+            std::cerr << name << ": " << error_msg << std::endl;
+            ok = false;
+        } catch (const std::exception &e) {
+            std::cerr << name << ": " << e.what() << std::endl;
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
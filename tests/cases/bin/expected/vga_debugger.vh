@@ -0,0 +1,16 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .pc(dbg_pc),
+
+`define VGA_DBG_Core_Outputs \
+    output wire [31:0] dbg_pc,
+
+`define VGA_DBG_Core_Assignments \
+    assign dbg_pc = pc;
+
+`define VGA_DBG_Core_Declaration \
+    wire [31:0] dbg_pc;
+
+`define VGA_DBG_Core_Arguments \
+    .dbg_pc(dbg_pc),
\ No newline at end of file
@@ -0,0 +1,84 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module Hex2Ascii(
+    input wire [3:0] hex,
+    output reg [7:0] ascii
+);
+
+    always @* begin
+        case (hex)
+            4'h0: ascii = 48;
+            4'h1: ascii = 49;
+            4'h2: ascii = 50;
+            4'h3: ascii = 51;
+            4'h4: ascii = 52;
+            4'h5: ascii = 53;
+            4'h6: ascii = 54;
+            4'h7: ascii = 55;
+            4'h8: ascii = 56;
+            4'h9: ascii = 57;
+            4'ha: ascii = 97;
+            4'hb: ascii = 98;
+            4'hc: ascii = 99;
+            4'hd: ascii = 100;
+            4'he: ascii = 101;
+            4'hf: ascii = 102;
+        endcase
+    end
+
+endmodule
+
+module VgaDebugger(
+    input wire [7:0] a,
+    input wire b,
+    input wire src_clk,
+    input wire clk,
+    output reg display_wen,
+    output wire [4:0] display_w_addr,
+    output wire [7:0] display_w_data
+);
+
+    // all wires are sampled at once on 'src_clk' and handed to 'clk' by a req/ack toggle handshake,
+    // 'snap_src' to 'snap' is held for the handshake and can be constrained as a false path
+    reg [8:0] snap_src = 0;
+    reg snap_req = 0;
+    reg snap_ack = 0;
+    (* ASYNC_REG = "TRUE" *) reg [1:0] snap_ack_sync = 0;
+    always @(posedge src_clk) begin
+        snap_ack_sync <= { snap_ack_sync[0], snap_ack };
+        if (snap_req == snap_ack_sync[1]) begin
+            snap_src <= { a, b };
+            snap_req <= ~snap_req;
+        end
+    end
+
+    reg [8:0] snap = 0;
+    (* ASYNC_REG = "TRUE" *) reg [1:0] snap_req_sync = 0;
+    always @(posedge clk) begin
+        snap_req_sync <= { snap_req_sync[0], snap_req };
+        if (snap_req_sync[1] != snap_ack) begin
+            snap <= snap_src;
+            snap_ack <= snap_req_sync[1];
+        end
+    end
+    wire [7:0] snap_a = snap[8:1];
+    wire snap_b = snap[0];
+
+    reg [4:0] display_addr = 0;
+    assign display_w_addr = display_addr;
+    always @(posedge clk) begin
+        display_addr <= display_addr == 31 ? 0 : display_addr + 1;
+    end
+
+    reg [3:0] dynamic_hex = 0;
+    Hex2Ascii hex2ascii(dynamic_hex, display_w_data);
+    always @* begin
+        case (display_addr)
+            19: begin dynamic_hex = snap_a[7:4]; display_wen = 1; end
+            20: begin dynamic_hex = snap_a[3:0]; display_wen = 1; end
+            26: begin dynamic_hex = snap_b; display_wen = 1; end
+            default: begin dynamic_hex = 0; display_wen = 0; end
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,22 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .a(dbg_a), \
+    .b(dbg_b), \
+    .src_clk(dbg_src_clk),
+
+`define VGA_DBG_Core_Outputs \
+    output wire [7:0] dbg_a, \
+    output wire dbg_b,
+
+`define VGA_DBG_Core_Assignments \
+    assign dbg_a = a; \
+    assign dbg_b = b;
+
+`define VGA_DBG_Core_Declaration \
+    wire [7:0] dbg_a; \
+    wire dbg_b;
+
+`define VGA_DBG_Core_Arguments \
+    .dbg_a(dbg_a), \
+    .dbg_b(dbg_b),
\ No newline at end of file
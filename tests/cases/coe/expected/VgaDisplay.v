@@ -0,0 +1,37 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module VgaDisplay(
+    input wire clk,
+    input wire video_on,
+    input wire [9:0] vga_x,
+    input wire [8:0] vga_y,
+    output wire [3:0] vga_r,
+    output wire [3:0] vga_g,
+    output wire [3:0] vga_b,
+    input wire wen,
+    input wire [7:0] w_addr,
+    input wire [7:0] w_data
+);
+
+    (* ram_style = "block" *) reg [7:0] display_data[0:255];
+    // 'vga_debugger.mem' can't be read by $readmemh, initialize this RAM through the vendor memory IP
+
+    // 40x4 characters of 8x16 pixels, rows are 64 characters apart in the RAM
+    // so that the address of a character is the high bits of its position
+    wire [7:0] text_index = { vga_y[5:4], vga_x[8:3] };
+    wire text_on = vga_x < 320 && vga_y < 64;
+    wire [7:0] text_ascii = display_data[text_index];
+
+    (* ram_style = "block" *) reg [7:0] fonts_data[0:4095];
+    initial $readmemh("font_8x16.mem", fonts_data);
+    wire [7:0] font_data = fonts_data[{ text_ascii, vga_y[3:0] }];
+
+    assign { vga_r, vga_g, vga_b } = (video_on & text_on & font_data[7 - vga_x[2:0]]) ? 12'hfff : 12'h0;
+
+    always @(posedge clk) begin
+        if (wen) begin
+            display_data[w_addr] <= w_data;
+        end
+    end
+
+endmodule
@@ -0,0 +1,43 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+// 'ascii' is the index of the character in the compact font
+module Hex2Ascii(
+    input wire [3:0] hex,
+    output reg [7:0] ascii
+);
+
+    always @* begin
+        case (hex)
+            4'h0: ascii = 2;
+            4'h1: ascii = 3;
+            4'hb: ascii = 6;
+            default: ascii = 0;
+        endcase
+    end
+
+endmodule
+
+module VgaDebugger(
+    input wire ok,
+    input wire clk,
+    output reg display_wen,
+    output wire [4:0] display_w_addr,
+    output wire [7:0] display_w_data
+);
+
+    reg [4:0] display_addr = 0;
+    assign display_w_addr = display_addr;
+    always @(posedge clk) begin
+        display_addr <= display_addr == 31 ? 0 : display_addr + 1;
+    end
+
+    reg [3:0] dynamic_hex = 0;
+    Hex2Ascii hex2ascii(dynamic_hex, display_w_data);
+    always @* begin
+        case (display_addr)
+            20: begin dynamic_hex = ok; display_wen = 1; end
+            default: begin dynamic_hex = 0; display_wen = 0; end
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,37 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module VgaDisplay(
+    input wire clk,
+    input wire video_on,
+    input wire [9:0] vga_x,
+    input wire [8:0] vga_y,
+    output wire [3:0] vga_r,
+    output wire [3:0] vga_g,
+    output wire [3:0] vga_b,
+    input wire wen,
+    input wire [4:0] w_addr,
+    input wire [7:0] w_data
+);
+
+    (* ram_style = "block" *) reg [7:0] display_data[0:31];
+    initial $readmemh("vga_debugger.mem", display_data);
+
+    // 16x2 characters of 8x16 pixels, rows are 16 characters apart in the RAM
+    // so that the address of a character is the high bits of its position
+    wire [4:0] text_index = { vga_y[4:4], vga_x[6:3] };
+    wire text_on = vga_x < 128 && vga_y < 32;
+    wire [7:0] text_glyph = display_data[text_index];
+
+    (* ram_style = "distributed" *) reg [7:0] fonts_data[0:175];
+    initial $readmemh("vga_debugger_font.mem", fonts_data);
+    wire [7:0] font_data = fonts_data[{ text_glyph[3:0], vga_y[3:0] }];
+
+    assign { vga_r, vga_g, vga_b } = (video_on & text_on & font_data[7 - vga_x[2:0]]) ? 12'hfff : 12'h0;
+
+    always @(posedge clk) begin
+        if (wen) begin
+            display_data[w_addr] <= w_data;
+        end
+    end
+
+endmodule
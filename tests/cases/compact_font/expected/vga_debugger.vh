@@ -0,0 +1,16 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .ok(dbg_ok),
+
+`define VGA_DBG_Core_Outputs \
+    output wire dbg_ok,
+
+`define VGA_DBG_Core_Assignments \
+    assign dbg_ok = ok;
+
+`define VGA_DBG_Core_Declaration \
+    wire dbg_ok;
+
+`define VGA_DBG_Core_Arguments \
+    .dbg_ok(dbg_ok),
\ No newline at end of file
@@ -0,0 +1,205 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module Hex2Ascii(
+    input wire [4:0] hex,
+    output reg [7:0] ascii
+);
+
+    always @* begin
+        case (hex)
+            4'h0: ascii = 48;
+            4'h1: ascii = 49;
+            4'h2: ascii = 50;
+            4'h3: ascii = 51;
+            4'h4: ascii = 52;
+            4'h5: ascii = 53;
+            4'h6: ascii = 54;
+            4'h7: ascii = 55;
+            4'h8: ascii = 56;
+            4'h9: ascii = 57;
+            4'ha: ascii = 97;
+            4'hb: ascii = 98;
+            4'hc: ascii = 99;
+            4'hd: ascii = 100;
+            4'he: ascii = 101;
+            4'hf: ascii = 102;
+            5'h10: ascii = 32;
+            5'h11: ascii = 45;
+            default: ascii = 32;
+        endcase
+    end
+
+endmodule
+
+// converts 'bin' to BCD digits by double dabble, 'STEP' bits are shifted in each registered stage, so
+// the digits lag 'bin' by 'WIDTH / STEP' cycles (rounded up), and one more if it is 'SIGNED'
+module Bin2Dec #(
+    parameter WIDTH = 8,
+    parameter DIGITS = 3,
+    parameter SIGNED = 0,
+    parameter STEP = 4
+) (
+    input wire clk,
+    input wire [WIDTH-1:0] bin,
+    output wire [DIGITS*4-1:0] bcd,
+    output wire neg
+);
+
+    localparam STAGES = (WIDTH + STEP - 1) / STEP;
+    localparam BCD = DIGITS * 4;
+
+    // the magnitude is registered before the stages, so that the negation is a path of its own
+    wire [WIDTH-1:0] mag;
+    wire mag_neg;
+    generate
+        if (SIGNED) begin : negate
+            reg [WIDTH-1:0] mag_r = 0;
+            reg neg_r = 0;
+            always @(posedge clk) begin
+                mag_r <= bin[WIDTH-1] ? -bin : bin;
+                neg_r <= bin[WIDTH-1];
+            end
+            assign mag = mag_r;
+            assign mag_neg = neg_r;
+        end else begin : unsigned_mag
+            assign mag = bin;
+            assign mag_neg = 0;
+        end
+    endgenerate
+
+    // digits, bits not shifted in yet (from the highest one) and the sign after each stage
+    wire [BCD*(STAGES+1)-1:0] digits;
+    wire [WIDTH*(STAGES+1)-1:0] rest;
+    wire [STAGES:0] signs;
+    assign digits[BCD-1:0] = 0;
+    assign rest[WIDTH-1:0] = mag;
+    assign signs[0] = mag_neg;
+
+    genvar s;
+    generate
+        for (s = 0; s < STAGES; s = s + 1) begin : stage
+            reg [BCD-1:0] digits_r = 0;
+            reg [WIDTH-1:0] rest_r = 0;
+            reg sign_r = 0;
+            reg [BCD-1:0] d;
+            reg [WIDTH-1:0] r;
+            integer i, k;
+            always @(posedge clk) begin
+                d = digits[s*BCD +: BCD];
+                r = rest[s*WIDTH +: WIDTH];
+                for (i = 0; i < STEP; i = i + 1) begin
+                    if (s * STEP + i < WIDTH) begin
+                        // digits of 5 or more are adjusted, so that they carry when doubled
+                        for (k = 0; k < DIGITS; k = k + 1) begin
+                            if (d[k*4 +: 4] >= 5) begin
+                                d[k*4 +: 4] = d[k*4 +: 4] + 3;
+                            end
+                        end
+                        d = { d[BCD-2:0], r[WIDTH-1] };
+                        r = r << 1;
+                    end
+                end
+                digits_r <= d;
+                rest_r <= r;
+                sign_r <= signs[s];
+            end
+            assign digits[(s+1)*BCD +: BCD] = digits_r;
+            assign rest[(s+1)*WIDTH +: WIDTH] = rest_r;
+            assign signs[s+1] = sign_r;
+        end
+    endgenerate
+
+    assign bcd = digits[STAGES*BCD +: BCD];
+    assign neg = signs[STAGES];
+
+endmodule
+
+module VgaDebugger(
+    input wire [32:0] cycles,
+    input wire [31:0] imm,
+    input wire [7:0] flags,
+    input wire [31:0] pc,
+    input wire [2:0] small,
+    input wire [4:0] neg,
+    input wire [15:0] label,
+    input wire clk,
+    output reg display_wen,
+    output wire [8:0] display_w_addr,
+    output wire [7:0] display_w_data
+);
+
+    wire [39:0] dec_cycles;
+    Bin2Dec #(.WIDTH(33), .DIGITS(10), .SIGNED(0)) bin2dec_cycles(
+        .clk(clk), .bin(cycles), .bcd(dec_cycles), .neg());
+    wire [39:0] dec_imm;
+    wire neg_imm;
+    Bin2Dec #(.WIDTH(32), .DIGITS(10), .SIGNED(1)) bin2dec_imm(
+        .clk(clk), .bin(imm), .bcd(dec_imm), .neg(neg_imm));
+    wire [3:0] dec_small;
+    Bin2Dec #(.WIDTH(3), .DIGITS(1), .SIGNED(0)) bin2dec_small(
+        .clk(clk), .bin(small), .bcd(dec_small), .neg());
+    wire [7:0] dec_neg;
+    wire neg_neg;
+    Bin2Dec #(.WIDTH(5), .DIGITS(2), .SIGNED(1)) bin2dec_neg(
+        .clk(clk), .bin(neg), .bcd(dec_neg), .neg(neg_neg));
+
+    reg [8:0] display_addr = 0;
+    assign display_w_addr = display_addr;
+    always @(posedge clk) begin
+        display_addr <= display_addr == 319 ? 0 : display_addr + 1;
+    end
+
+    reg [4:0] dynamic_hex = 0;
+    Hex2Ascii hex2ascii(dynamic_hex, display_w_data);
+    always @* begin
+        case (display_addr)
+            88: begin dynamic_hex = dec_cycles[39:36]; display_wen = 1; end
+            89: begin dynamic_hex = dec_cycles[35:32]; display_wen = 1; end
+            90: begin dynamic_hex = dec_cycles[31:28]; display_wen = 1; end
+            91: begin dynamic_hex = dec_cycles[27:24]; display_wen = 1; end
+            92: begin dynamic_hex = dec_cycles[23:20]; display_wen = 1; end
+            93: begin dynamic_hex = dec_cycles[19:16]; display_wen = 1; end
+            94: begin dynamic_hex = dec_cycles[15:12]; display_wen = 1; end
+            95: begin dynamic_hex = dec_cycles[11:8]; display_wen = 1; end
+            96: begin dynamic_hex = dec_cycles[7:4]; display_wen = 1; end
+            97: begin dynamic_hex = dec_cycles[3:0]; display_wen = 1; end
+            105: begin dynamic_hex = { 4'b1000, neg_imm }; display_wen = 1; end
+            106: begin dynamic_hex = dec_imm[39:36]; display_wen = 1; end
+            107: begin dynamic_hex = dec_imm[35:32]; display_wen = 1; end
+            108: begin dynamic_hex = dec_imm[31:28]; display_wen = 1; end
+            109: begin dynamic_hex = dec_imm[27:24]; display_wen = 1; end
+            110: begin dynamic_hex = dec_imm[23:20]; display_wen = 1; end
+            111: begin dynamic_hex = dec_imm[19:16]; display_wen = 1; end
+            112: begin dynamic_hex = dec_imm[15:12]; display_wen = 1; end
+            113: begin dynamic_hex = dec_imm[11:8]; display_wen = 1; end
+            114: begin dynamic_hex = dec_imm[7:4]; display_wen = 1; end
+            115: begin dynamic_hex = dec_imm[3:0]; display_wen = 1; end
+            125: begin dynamic_hex = flags[7]; display_wen = 1; end
+            126: begin dynamic_hex = flags[6]; display_wen = 1; end
+            127: begin dynamic_hex = flags[5]; display_wen = 1; end
+            128: begin dynamic_hex = flags[4]; display_wen = 1; end
+            129: begin dynamic_hex = flags[3]; display_wen = 1; end
+            130: begin dynamic_hex = flags[2]; display_wen = 1; end
+            131: begin dynamic_hex = flags[1]; display_wen = 1; end
+            132: begin dynamic_hex = flags[0]; display_wen = 1; end
+            164: begin dynamic_hex = pc[31:28]; display_wen = 1; end
+            165: begin dynamic_hex = pc[27:24]; display_wen = 1; end
+            166: begin dynamic_hex = pc[23:20]; display_wen = 1; end
+            167: begin dynamic_hex = pc[19:16]; display_wen = 1; end
+            168: begin dynamic_hex = pc[15:12]; display_wen = 1; end
+            169: begin dynamic_hex = pc[11:8]; display_wen = 1; end
+            170: begin dynamic_hex = pc[7:4]; display_wen = 1; end
+            171: begin dynamic_hex = pc[3:0]; display_wen = 1; end
+            181: begin dynamic_hex = dec_small[3:0]; display_wen = 1; end
+            189: begin dynamic_hex = { 4'b1000, neg_neg }; display_wen = 1; end
+            190: begin dynamic_hex = dec_neg[7:4]; display_wen = 1; end
+            191: begin dynamic_hex = dec_neg[3:0]; display_wen = 1; end
+            207: begin dynamic_hex = label[15:12]; display_wen = 1; end
+            208: begin dynamic_hex = label[11:8]; display_wen = 1; end
+            209: begin dynamic_hex = label[7:4]; display_wen = 1; end
+            210: begin dynamic_hex = label[3:0]; display_wen = 1; end
+            default: begin dynamic_hex = 0; display_wen = 0; end
+        endcase
+    end
+
+endmodule
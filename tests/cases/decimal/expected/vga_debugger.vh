@@ -0,0 +1,46 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .cycles(dbg_cycles), \
+    .imm(dbg_imm), \
+    .flags(dbg_flags), \
+    .pc(dbg_pc), \
+    .small(dbg_small), \
+    .neg(dbg_neg), \
+    .label(dbg_label),
+
+`define VGA_DBG_Top_Outputs \
+    output wire [32:0] dbg_cycles, \
+    output wire [31:0] dbg_imm, \
+    output wire [7:0] dbg_flags, \
+    output wire [31:0] dbg_pc, \
+    output wire [2:0] dbg_small, \
+    output wire [4:0] dbg_neg, \
+    output wire [15:0] dbg_label,
+
+`define VGA_DBG_Top_Assignments \
+    assign dbg_cycles = cycles; \
+    assign dbg_imm = imm; \
+    assign dbg_flags = flags; \
+    assign dbg_pc = pc; \
+    assign dbg_small = small; \
+    assign dbg_neg = neg; \
+    assign dbg_label = label;
+
+`define VGA_DBG_Top_Declaration \
+    wire [32:0] dbg_cycles; \
+    wire [31:0] dbg_imm; \
+    wire [7:0] dbg_flags; \
+    wire [31:0] dbg_pc; \
+    wire [2:0] dbg_small; \
+    wire [4:0] dbg_neg; \
+    wire [15:0] dbg_label;
+
+`define VGA_DBG_Top_Arguments \
+    .dbg_cycles(dbg_cycles), \
+    .dbg_imm(dbg_imm), \
+    .dbg_flags(dbg_flags), \
+    .dbg_pc(dbg_pc), \
+    .dbg_small(dbg_small), \
+    .dbg_neg(dbg_neg), \
+    .dbg_label(dbg_label),
\ No newline at end of file
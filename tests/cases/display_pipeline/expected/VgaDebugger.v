@@ -0,0 +1,58 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module Hex2Ascii(
+    input wire [3:0] hex,
+    output reg [7:0] ascii
+);
+
+    always @* begin
+        case (hex)
+            4'h0: ascii = 48;
+            4'h1: ascii = 49;
+            4'h2: ascii = 50;
+            4'h3: ascii = 51;
+            4'h4: ascii = 52;
+            4'h5: ascii = 53;
+            4'h6: ascii = 54;
+            4'h7: ascii = 55;
+            4'h8: ascii = 56;
+            4'h9: ascii = 57;
+            4'ha: ascii = 97;
+            4'hb: ascii = 98;
+            4'hc: ascii = 99;
+            4'hd: ascii = 100;
+            4'he: ascii = 101;
+            4'hf: ascii = 102;
+        endcase
+    end
+
+endmodule
+
+module VgaDebugger(
+    input wire [31:0] pc,
+    input wire clk,
+    output reg [1:0] display_wen,
+    output wire [3:0] display_w_addr,
+    output wire [15:0] display_w_data
+);
+
+    reg [3:0] display_addr = 0;
+    assign display_w_addr = display_addr;
+    always @(posedge clk) begin
+        display_addr <= display_addr == 15 ? 0 : display_addr + 1;
+    end
+
+    reg [7:0] dynamic_hex = 0;
+    Hex2Ascii hex2ascii_0(dynamic_hex[3:0], display_w_data[7:0]);
+    Hex2Ascii hex2ascii_1(dynamic_hex[7:4], display_w_data[15:8]);
+    always @* begin
+        case (display_addr)
+            10: begin dynamic_hex[3:0] = pc[31:28]; dynamic_hex[7:4] = pc[27:24]; display_wen = 2'b11; end
+            11: begin dynamic_hex[3:0] = pc[23:20]; dynamic_hex[7:4] = pc[19:16]; display_wen = 2'b11; end
+            12: begin dynamic_hex[3:0] = pc[15:12]; dynamic_hex[7:4] = pc[11:8]; display_wen = 2'b11; end
+            13: begin dynamic_hex[3:0] = pc[7:4]; dynamic_hex[7:4] = pc[3:0]; display_wen = 2'b11; end
+            default: begin dynamic_hex = 0; display_wen = 0; end
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,71 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module VgaDisplay(
+    input wire clk,
+    input wire video_on,
+    input wire [9:0] vga_x,
+    input wire [8:0] vga_y,
+    input wire hs,
+    input wire vs,
+    output wire [3:0] vga_r,
+    output wire [3:0] vga_g,
+    output wire [3:0] vga_b,
+    output wire vga_hs,
+    output wire vga_vs,
+    input wire [1:0] wen,
+    input wire [3:0] w_addr,
+    input wire [15:0] w_data
+);
+
+    (* ram_style = "block" *) reg [15:0] display_data[0:15];
+    initial $readmemh("vga_debugger.mem", display_data);
+
+    // 16x2 characters of 8x16 pixels, rows are 16 characters apart in the RAM
+    // so that the address of a character is the high bits of its position
+    wire [4:0] text_index = { vga_y[4:4], vga_x[6:3] };
+    wire text_on = vga_x < 128 && vga_y < 32;
+
+    (* ram_style = "block" *) reg [7:0] fonts_data[0:4095];
+    initial $readmemh("font_8x16.mem", fonts_data);
+
+    // both memories are read into registers and the colour is registered too
+    // so the position, 'text_on' and the syncs are delayed by 3 cycles
+    reg [15:0] text_word;
+    reg [0:0] text_lane;
+    wire [7:0] text_ascii = text_word[text_lane * 8 +: 8];
+    reg [3:0] font_y;
+    reg [2:0] font_x_1, font_x_2;
+    reg text_on_1, text_on_2;
+    reg [7:0] font_data;
+    reg [11:0] color;
+    reg [2:0] hs_delay, vs_delay;
+    always @(posedge clk) begin
+        text_word <= display_data[text_index[4:1]];
+        text_lane <= text_index[0:0];
+        font_y <= vga_y[3:0];
+        font_x_1 <= vga_x[2:0];
+        text_on_1 <= video_on & text_on;
+
+        font_data <= fonts_data[{ text_ascii, font_y }];
+        font_x_2 <= font_x_1;
+        text_on_2 <= text_on_1;
+
+        color <= (text_on_2 & font_data[7 - font_x_2]) ? 12'hfff : 12'h0;
+        hs_delay <= { hs_delay[1:0], hs };
+        vs_delay <= { vs_delay[1:0], vs };
+    end
+
+    assign { vga_r, vga_g, vga_b } = color;
+    assign vga_hs = hs_delay[2];
+    assign vga_vs = vs_delay[2];
+
+    always @(posedge clk) begin
+        if (wen[0]) begin
+            display_data[w_addr][7:0] <= w_data[7:0];
+        end
+        if (wen[1]) begin
+            display_data[w_addr][15:8] <= w_data[15:8];
+        end
+    end
+
+endmodule
@@ -0,0 +1,79 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module Hex2Ascii(
+    input wire [3:0] hex,
+    output reg [7:0] ascii
+);
+
+    always @* begin
+        case (hex)
+            4'h0: ascii = 48;
+            4'h1: ascii = 49;
+            4'h2: ascii = 50;
+            4'h3: ascii = 51;
+            4'h4: ascii = 52;
+            4'h5: ascii = 53;
+            4'h6: ascii = 54;
+            4'h7: ascii = 55;
+            4'h8: ascii = 56;
+            4'h9: ascii = 57;
+            4'ha: ascii = 97;
+            4'hb: ascii = 98;
+            4'hc: ascii = 99;
+            4'hd: ascii = 100;
+            4'he: ascii = 101;
+            4'hf: ascii = 102;
+        endcase
+    end
+
+endmodule
+
+module VgaDebugger(
+    input wire [31:0] pc,
+    input wire [4:0] rs1,
+    input wire [4:0] rd,
+    input wire [31:0] imm,
+    input wire wen,
+    input wire clk,
+    output reg display_wen,
+    output wire [7:0] display_w_addr,
+    output wire [7:0] display_w_data
+);
+
+    reg [4:0] nibble_index = 0;
+    always @(posedge clk) begin
+        nibble_index <= nibble_index == 20 ? 0 : nibble_index + 1;
+    end
+
+    reg [7:0] display_addr;
+    assign display_w_addr = display_addr;
+    reg [3:0] dynamic_hex;
+    Hex2Ascii hex2ascii(dynamic_hex, display_w_data);
+    always @* begin
+        case (nibble_index)
+            0: begin display_addr = 44; dynamic_hex = pc[31:28]; display_wen = 1; end
+            1: begin display_addr = 45; dynamic_hex = pc[27:24]; display_wen = 1; end
+            2: begin display_addr = 46; dynamic_hex = pc[23:20]; display_wen = 1; end
+            3: begin display_addr = 47; dynamic_hex = pc[19:16]; display_wen = 1; end
+            4: begin display_addr = 48; dynamic_hex = pc[15:12]; display_wen = 1; end
+            5: begin display_addr = 49; dynamic_hex = pc[11:8]; display_wen = 1; end
+            6: begin display_addr = 50; dynamic_hex = pc[7:4]; display_wen = 1; end
+            7: begin display_addr = 51; dynamic_hex = pc[3:0]; display_wen = 1; end
+            8: begin display_addr = 59; dynamic_hex = rs1[4:4]; display_wen = 1; end
+            9: begin display_addr = 60; dynamic_hex = rs1[3:0]; display_wen = 1; end
+            10: begin display_addr = 67; dynamic_hex = rd[4:4]; display_wen = 1; end
+            11: begin display_addr = 68; dynamic_hex = rd[3:0]; display_wen = 1; end
+            12: begin display_addr = 85; dynamic_hex = imm[31:28]; display_wen = 1; end
+            13: begin display_addr = 86; dynamic_hex = imm[27:24]; display_wen = 1; end
+            14: begin display_addr = 87; dynamic_hex = imm[23:20]; display_wen = 1; end
+            15: begin display_addr = 88; dynamic_hex = imm[19:16]; display_wen = 1; end
+            16: begin display_addr = 89; dynamic_hex = imm[15:12]; display_wen = 1; end
+            17: begin display_addr = 90; dynamic_hex = imm[11:8]; display_wen = 1; end
+            18: begin display_addr = 91; dynamic_hex = imm[7:4]; display_wen = 1; end
+            19: begin display_addr = 92; dynamic_hex = imm[3:0]; display_wen = 1; end
+            20: begin display_addr = 100; dynamic_hex = wen; display_wen = 1; end
+            default: begin display_addr = 0; dynamic_hex = 0; display_wen = 0; end
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,36 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .pc(dbg_pc), \
+    .rs1(dbg_rs1), \
+    .rd(dbg_rd), \
+    .imm(dbg_imm), \
+    .wen(dbg_wen),
+
+`define VGA_DBG_Core_Outputs \
+    output wire [31:0] dbg_pc, \
+    output wire [4:0] dbg_rs1, \
+    output wire [4:0] dbg_rd, \
+    output wire [31:0] dbg_imm, \
+    output wire dbg_wen,
+
+`define VGA_DBG_Core_Assignments \
+    assign dbg_pc = pc; \
+    assign dbg_rs1 = rs1; \
+    assign dbg_rd = rd; \
+    assign dbg_imm = imm; \
+    assign dbg_wen = wen;
+
+`define VGA_DBG_Core_Declaration \
+    wire [31:0] dbg_pc; \
+    wire [4:0] dbg_rs1; \
+    wire [4:0] dbg_rd; \
+    wire [31:0] dbg_imm; \
+    wire dbg_wen;
+
+`define VGA_DBG_Core_Arguments \
+    .dbg_pc(dbg_pc), \
+    .dbg_rs1(dbg_rs1), \
+    .dbg_rd(dbg_rd), \
+    .dbg_imm(dbg_imm), \
+    .dbg_wen(dbg_wen),
\ No newline at end of file
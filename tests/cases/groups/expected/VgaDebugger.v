@@ -0,0 +1,69 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module Hex2Ascii(
+    input wire [3:0] hex,
+    output reg [7:0] ascii
+);
+
+    always @* begin
+        case (hex)
+            4'h0: ascii = 48;
+            4'h1: ascii = 49;
+            4'h2: ascii = 50;
+            4'h3: ascii = 51;
+            4'h4: ascii = 52;
+            4'h5: ascii = 53;
+            4'h6: ascii = 54;
+            4'h7: ascii = 55;
+            4'h8: ascii = 56;
+            4'h9: ascii = 57;
+            4'ha: ascii = 97;
+            4'hb: ascii = 98;
+            4'hc: ascii = 99;
+            4'hd: ascii = 100;
+            4'he: ascii = 101;
+            4'hf: ascii = 102;
+        endcase
+    end
+
+endmodule
+
+module VgaDebugger(
+    input wire [2:0] a_x1,
+    input wire [4:0] a_x2_b,
+    input wire [4:0] own_x3_b,
+    input wire [31:0] pc,
+    input wire clk,
+    output reg display_wen,
+    output wire [7:0] display_w_addr,
+    output wire [7:0] display_w_data
+);
+
+    reg [7:0] display_addr = 0;
+    assign display_w_addr = display_addr;
+    always @(posedge clk) begin
+        display_addr <= display_addr == 159 ? 0 : display_addr + 1;
+    end
+
+    reg [3:0] dynamic_hex = 0;
+    Hex2Ascii hex2ascii(dynamic_hex, display_w_data);
+    always @* begin
+        case (display_addr)
+            44: begin dynamic_hex = a_x1[2:0]; display_wen = 1; end
+            51: begin dynamic_hex = a_x2_b[4:4]; display_wen = 1; end
+            52: begin dynamic_hex = a_x2_b[3:0]; display_wen = 1; end
+            59: begin dynamic_hex = own_x3_b[4:4]; display_wen = 1; end
+            60: begin dynamic_hex = own_x3_b[3:0]; display_wen = 1; end
+            67: begin dynamic_hex = pc[31:28]; display_wen = 1; end
+            68: begin dynamic_hex = pc[27:24]; display_wen = 1; end
+            69: begin dynamic_hex = pc[23:20]; display_wen = 1; end
+            70: begin dynamic_hex = pc[19:16]; display_wen = 1; end
+            71: begin dynamic_hex = pc[15:12]; display_wen = 1; end
+            72: begin dynamic_hex = pc[11:8]; display_wen = 1; end
+            73: begin dynamic_hex = pc[7:4]; display_wen = 1; end
+            74: begin dynamic_hex = pc[3:0]; display_wen = 1; end
+            default: begin dynamic_hex = 0; display_wen = 0; end
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,45 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .a_x1(dbg_a_x1), \
+    .a_x2_b(dbg_a_x2_b), \
+    .own_x3_b(dbg_own_x3_b), \
+    .pc(dbg_pc),
+
+`define VGA_DBG_Core_Outputs \
+    output wire [2:0] dbg_a_x1, \
+    output wire [4:0] dbg_a_x2_b, \
+    output wire [4:0] dbg_own_x3_b, \
+    output wire [31:0] dbg_pc,
+
+`define VGA_DBG_Core_Assignments \
+    assign dbg_a_x1 = a_x1;
+
+`define VGA_DBG_Core_Declaration \
+    wire [2:0] dbg_a_x1;
+
+`define VGA_DBG_Core_Arguments \
+    .dbg_a_x1(dbg_a_x1), \
+    .dbg_a_x2_b(dbg_a_x2_b), \
+    .dbg_own_x3_b(dbg_own_x3_b), \
+    .dbg_pc(dbg_pc),
+
+`define VGA_DBG_RegFile_Outputs \
+    output wire [4:0] dbg_a_x2_b, \
+    output wire [4:0] dbg_own_x3_b, \
+    output wire [31:0] dbg_pc,
+
+`define VGA_DBG_RegFile_Assignments \
+    assign dbg_a_x2_b = a_x2_b; \
+    assign dbg_own_x3_b = own_x3_b; \
+    assign dbg_pc = pc;
+
+`define VGA_DBG_RegFile_Declaration \
+    wire [4:0] dbg_a_x2_b; \
+    wire [4:0] dbg_own_x3_b; \
+    wire [31:0] dbg_pc;
+
+`define VGA_DBG_RegFile_Arguments \
+    .dbg_a_x2_b(dbg_a_x2_b), \
+    .dbg_own_x3_b(dbg_own_x3_b), \
+    .dbg_pc(dbg_pc),
\ No newline at end of file
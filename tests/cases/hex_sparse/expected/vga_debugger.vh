@@ -0,0 +1,21 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .pc(dbg_pc), \
+    .ok(dbg_ok),
+
+`define VGA_DBG_Core_Outputs \
+    output wire [31:0] dbg_pc, \
+    output wire dbg_ok,
+
+`define VGA_DBG_Core_Assignments \
+    assign dbg_pc = pc; \
+    assign dbg_ok = ok;
+
+`define VGA_DBG_Core_Declaration \
+    wire [31:0] dbg_pc; \
+    wire dbg_ok;
+
+`define VGA_DBG_Core_Arguments \
+    .dbg_pc(dbg_pc), \
+    .dbg_ok(dbg_ok),
\ No newline at end of file
@@ -0,0 +1,69 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module Hex2Ascii(
+    input wire [3:0] hex,
+    output reg [7:0] ascii
+);
+
+    always @* begin
+        case (hex)
+            4'h0: ascii = 48;
+            4'h1: ascii = 49;
+            4'h2: ascii = 50;
+            4'h3: ascii = 51;
+            4'h4: ascii = 52;
+            4'h5: ascii = 53;
+            4'h6: ascii = 54;
+            4'h7: ascii = 55;
+            4'h8: ascii = 56;
+            4'h9: ascii = 57;
+            4'ha: ascii = 97;
+            4'hb: ascii = 98;
+            4'hc: ascii = 99;
+            4'hd: ascii = 100;
+            4'he: ascii = 101;
+            4'hf: ascii = 102;
+        endcase
+    end
+
+endmodule
+
+module VgaDebugger(
+    input wire [31:0] pc,
+    input wire [31:0] inst,
+    input wire [4:0] rd,
+    input wire [31:0] alu_res,
+    input wire cmp,
+    input wire clk,
+    output reg [3:0] display_wen,
+    output wire [5:0] display_w_addr,
+    output wire [31:0] display_w_data
+);
+
+    reg [5:0] display_addr = 0;
+    assign display_w_addr = display_addr;
+    always @(posedge clk) begin
+        display_addr <= display_addr == 39 ? 0 : display_addr + 1;
+    end
+
+    reg [15:0] dynamic_hex = 0;
+    Hex2Ascii hex2ascii_0(dynamic_hex[3:0], display_w_data[7:0]);
+    Hex2Ascii hex2ascii_1(dynamic_hex[7:4], display_w_data[15:8]);
+    Hex2Ascii hex2ascii_2(dynamic_hex[11:8], display_w_data[23:16]);
+    Hex2Ascii hex2ascii_3(dynamic_hex[15:12], display_w_data[31:24]);
+    always @* begin
+        case (display_addr)
+            11: begin dynamic_hex[3:0] = pc[31:28]; dynamic_hex[7:4] = pc[27:24]; dynamic_hex[11:8] = pc[23:20]; dynamic_hex[15:12] = pc[19:16]; display_wen = 4'b1111; end
+            12: begin dynamic_hex[3:0] = pc[15:12]; dynamic_hex[7:4] = pc[11:8]; dynamic_hex[11:8] = pc[7:4]; dynamic_hex[15:12] = pc[3:0]; display_wen = 4'b1111; end
+            15: begin dynamic_hex[3:0] = inst[31:28]; dynamic_hex[7:4] = inst[27:24]; dynamic_hex[11:8] = inst[23:20]; dynamic_hex[15:12] = inst[19:16]; display_wen = 4'b1111; end
+            16: begin dynamic_hex[3:0] = inst[15:12]; dynamic_hex[7:4] = inst[11:8]; dynamic_hex[11:8] = inst[7:4]; dynamic_hex[15:12] = inst[3:0]; display_wen = 4'b1111; end
+            21: begin dynamic_hex[3:0] = rd[4:4]; dynamic_hex[7:4] = rd[3:0]; dynamic_hex[11:8] = 0; dynamic_hex[15:12] = 0; display_wen = 4'b0011; end
+            24: begin dynamic_hex[3:0] = 0; dynamic_hex[7:4] = alu_res[31:28]; dynamic_hex[11:8] = alu_res[27:24]; dynamic_hex[15:12] = alu_res[23:20]; display_wen = 4'b1110; end
+            25: begin dynamic_hex[3:0] = alu_res[19:16]; dynamic_hex[7:4] = alu_res[15:12]; dynamic_hex[11:8] = alu_res[11:8]; dynamic_hex[15:12] = alu_res[7:4]; display_wen = 4'b1111; end
+            26: begin dynamic_hex[3:0] = alu_res[3:0]; dynamic_hex[7:4] = 0; dynamic_hex[11:8] = 0; dynamic_hex[15:12] = 0; display_wen = 4'b0001; end
+            28: begin dynamic_hex[3:0] = cmp; dynamic_hex[7:4] = 0; dynamic_hex[11:8] = 0; dynamic_hex[15:12] = 0; display_wen = 4'b0001; end
+            default: begin dynamic_hex = 0; display_wen = 0; end
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,36 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .pc(dbg_pc), \
+    .inst(dbg_inst), \
+    .rd(dbg_rd), \
+    .alu_res(dbg_alu_res), \
+    .cmp(dbg_cmp),
+
+`define VGA_DBG_Core_Outputs \
+    output wire [31:0] dbg_pc, \
+    output wire [31:0] dbg_inst, \
+    output wire [4:0] dbg_rd, \
+    output wire [31:0] dbg_alu_res, \
+    output wire dbg_cmp,
+
+`define VGA_DBG_Core_Assignments \
+    assign dbg_pc = pc; \
+    assign dbg_inst = inst; \
+    assign dbg_rd = rd; \
+    assign dbg_alu_res = alu_res; \
+    assign dbg_cmp = cmp;
+
+`define VGA_DBG_Core_Declaration \
+    wire [31:0] dbg_pc; \
+    wire [31:0] dbg_inst; \
+    wire [4:0] dbg_rd; \
+    wire [31:0] dbg_alu_res; \
+    wire dbg_cmp;
+
+`define VGA_DBG_Core_Arguments \
+    .dbg_pc(dbg_pc), \
+    .dbg_inst(dbg_inst), \
+    .dbg_rd(dbg_rd), \
+    .dbg_alu_res(dbg_alu_res), \
+    .dbg_cmp(dbg_cmp),
\ No newline at end of file
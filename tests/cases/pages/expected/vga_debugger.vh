@@ -0,0 +1,54 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+`define VGA_DBG_VgaDebugger_Arguments \
+    .pc(dbg_pc), \
+    .inst(dbg_inst), \
+    .rd(dbg_rd), \
+    .wen(dbg_wen), \
+    .x1(dbg_x1), \
+    .x2(dbg_x2), \
+    .page(dbg_page),
+
+`define VGA_DBG_Core_Outputs \
+    output wire [31:0] dbg_pc, \
+    output wire [31:0] dbg_inst, \
+    output wire [4:0] dbg_rd, \
+    output wire dbg_wen, \
+    output wire [31:0] dbg_x1, \
+    output wire [31:0] dbg_x2,
+
+`define VGA_DBG_Core_Assignments \
+    assign dbg_pc = pc; \
+    assign dbg_inst = inst; \
+    assign dbg_rd = rd; \
+    assign dbg_wen = wen;
+
+`define VGA_DBG_Core_Declaration \
+    wire [31:0] dbg_pc; \
+    wire [31:0] dbg_inst; \
+    wire [4:0] dbg_rd; \
+    wire dbg_wen;
+
+`define VGA_DBG_Core_Arguments \
+    .dbg_pc(dbg_pc), \
+    .dbg_inst(dbg_inst), \
+    .dbg_rd(dbg_rd), \
+    .dbg_wen(dbg_wen), \
+    .dbg_x1(dbg_x1), \
+    .dbg_x2(dbg_x2),
+
+`define VGA_DBG_RegFile_Outputs \
+    output wire [31:0] dbg_x1, \
+    output wire [31:0] dbg_x2,
+
+`define VGA_DBG_RegFile_Assignments \
+    assign dbg_x1 = x1; \
+    assign dbg_x2 = x2;
+
+`define VGA_DBG_RegFile_Declaration \
+    wire [31:0] dbg_x1; \
+    wire [31:0] dbg_x2;
+
+`define VGA_DBG_RegFile_Arguments \
+    .dbg_x1(dbg_x1), \
+    .dbg_x2(dbg_x2),
\ No newline at end of file
@@ -0,0 +1,87 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module Hex2Ascii(
+    input wire [3:0] hex,
+    output reg [7:0] ascii
+);
+
+    always @* begin
+        case (hex)
+            4'h0: ascii = 48;
+            4'h1: ascii = 49;
+            4'h2: ascii = 50;
+            4'h3: ascii = 51;
+            4'h4: ascii = 52;
+            4'h5: ascii = 53;
+            4'h6: ascii = 54;
+            4'h7: ascii = 55;
+            4'h8: ascii = 56;
+            4'h9: ascii = 57;
+            4'ha: ascii = 97;
+            4'hb: ascii = 98;
+            4'hc: ascii = 99;
+            4'hd: ascii = 100;
+            4'he: ascii = 101;
+            4'hf: ascii = 102;
+        endcase
+    end
+
+endmodule
+
+module VgaDebugger(
+    input wire [7:0] a,
+    input wire [11:0] b,
+    input wire clk,
+    output reg display_wen,
+    output wire [4:0] display_w_addr,
+    output wire [7:0] display_w_data
+);
+
+    reg [4:0] display_addr = 0;
+    always @(posedge clk) begin
+        display_addr <= display_addr == 31 ? 0 : display_addr + 1;
+    end
+
+    // a one-hot AND-OR tree of 2 registered stage(s) with a fan-in of 3, writes lag the scan by 2 cycle(s)
+    wire [4:0] scan_key = display_addr;
+    wire [4:0] scan_addr = scan_key;
+    wire [4:0] arm_hit;
+    wire [19:0] arm_hex;
+    assign arm_hit[0] = scan_key == 19;
+    assign arm_hex[3:0] = a[7:4];
+    assign arm_hit[1] = scan_key == 20;
+    assign arm_hex[7:4] = a[3:0];
+    assign arm_hit[2] = scan_key == 26;
+    assign arm_hex[11:8] = b[11:8];
+    assign arm_hit[3] = scan_key == 27;
+    assign arm_hex[15:12] = b[7:4];
+    assign arm_hit[4] = scan_key == 28;
+    assign arm_hex[19:16] = b[3:0];
+
+    reg [1:0] stage1_hit = 0;
+    reg [7:0] stage1_hex = 0;
+    reg [4:0] stage1_addr = 0;
+    always @(posedge clk) begin
+        stage1_addr <= scan_addr;
+        stage1_hit[0] <= arm_hit[0] | arm_hit[1] | arm_hit[2];
+        stage1_hex[3:0] <= (arm_hex[3:0] & {4{arm_hit[0]}}) | (arm_hex[7:4] & {4{arm_hit[1]}}) | (arm_hex[11:8] & {4{arm_hit[2]}});
+        stage1_hit[1] <= arm_hit[3] | arm_hit[4];
+        stage1_hex[7:4] <= (arm_hex[15:12] & {4{arm_hit[3]}}) | (arm_hex[19:16] & {4{arm_hit[4]}});
+    end
+
+    reg [0:0] stage2_hit = 0;
+    reg [3:0] stage2_hex = 0;
+    reg [4:0] stage2_addr = 0;
+    always @(posedge clk) begin
+        stage2_addr <= stage1_addr;
+        stage2_hit[0] <= stage1_hit[0] | stage1_hit[1];
+        stage2_hex[3:0] <= stage1_hex[3:0] | stage1_hex[7:4];
+    end
+
+    assign display_w_addr = stage2_addr;
+    always @* begin
+        display_wen = stage2_hit[0];
+    end
+    Hex2Ascii hex2ascii(stage2_hex, display_w_data);
+
+endmodule
@@ -0,0 +1,38 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+// 640x480 in 800x527 pixels, 'clk' is the pixel clock, which is 25.296 MHz for 60 Hz
+module VgaController(
+    input wire clk,
+    input wire rst,
+    output reg [9:0] vga_x,
+    output reg [8:0] vga_y,
+    output reg hs,
+    output reg vs,
+    output reg video_on
+);
+
+    // each line (and frame) is the visible area, the front porch, the sync pulse and the back porch
+    reg [9:0] h_count = 0;
+    reg [9:0] v_count = 0;
+    always @(posedge clk) begin
+        if (rst) begin
+            h_count <= 0;
+            v_count <= 0;
+        end else if (h_count == 799) begin
+            h_count <= 0;
+            v_count <= v_count == 526 ? 0 : v_count + 1;
+        end else begin
+            h_count <= h_count + 1;
+        end
+    end
+
+    // all outputs are registered, so that they are aligned
+    always @(posedge clk) begin
+        vga_x <= h_count;
+        vga_y <= v_count;
+        video_on <= h_count < 640 && v_count < 480;
+        hs <= h_count >= 656 && h_count < 752 ? 1 : 0;
+        vs <= v_count >= 492 && v_count < 494 ? 0 : 1;
+    end
+
+endmodule
@@ -0,0 +1,37 @@
+// generated by vga-debugger-generator (Pepcy Chen)
+
+module VgaDisplay(
+    input wire clk,
+    input wire video_on,
+    input wire [9:0] vga_x,
+    input wire [8:0] vga_y,
+    output wire [3:0] vga_r,
+    output wire [3:0] vga_g,
+    output wire [3:0] vga_b,
+    input wire wen,
+    input wire [6:0] w_addr,
+    input wire [7:0] w_data
+);
+
+    (* ram_style = "block" *) reg [7:0] display_data[0:95];
+    initial $readmemh("vga_debugger.mem", display_data);
+
+    // 20x3 characters of 4x8 pixels, rows are 32 characters apart in the RAM
+    // so that the address of a character is the high bits of its position
+    wire [6:0] text_index = { vga_y[4:3], vga_x[6:2] };
+    wire text_on = vga_x < 80 && vga_y < 24;
+    wire [7:0] text_ascii = display_data[text_index];
+
+    (* ram_style = "block" *) reg [7:0] fonts_data[0:2047];
+    initial $readmemh("font_8x16.mem", fonts_data);
+    wire [7:0] font_data = fonts_data[{ text_ascii, vga_y[2:0] }];
+
+    assign { vga_r, vga_g, vga_b } = (video_on & text_on & font_data[7 - vga_x[1:0]]) ? 12'hfff : 12'h0;
+
+    always @(posedge clk) begin
+        if (wen) begin
+            display_data[w_addr] <= w_data;
+        end
+    end
+
+endmodule
@@ -24,8 +24,7 @@ module VgaDisplay(
     initial $readmemh("vga_debugger.mem", display_data);
 
     wire [11:0] text_index = (vga_y / 16) * 80 + vga_x / 8;
-    // I don't know why I need this '- (vga_y / 16)' ...
-    wire [7:0] text_ascii = display_data[text_index] - (vga_y / 16);
+    wire [7:0] text_ascii = display_data[text_index];
     wire [2:0] font_x = vga_x % 8;
     wire [3:0] font_y = vga_y % 16;
     wire [11:0] font_addr = text_ascii * 16 + font_y;